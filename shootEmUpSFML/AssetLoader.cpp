@@ -0,0 +1,155 @@
+#include "AssetLoader.hpp"
+#include <iostream>
+#include <stdexcept>
+
+std::vector<std::unique_ptr<AssetLoader::Job>> AssetLoader::jobs;
+std::atomic<std::size_t> AssetLoader::nextJob{ 0 };
+std::vector<std::thread> AssetLoader::workers;
+std::size_t AssetLoader::finishedCount = 0;
+
+std::unordered_map<std::string, std::shared_ptr<sf::Texture>> AssetLoader::textures;
+std::unordered_map<std::string, std::shared_ptr<sf::SoundBuffer>> AssetLoader::sounds;
+
+namespace {
+    sf::Clock loadClock;
+}
+
+std::string AssetLoader::keyOf(const std::filesystem::path& path) {
+    return path.lexically_normal().generic_string();
+}
+
+void AssetLoader::start(const std::vector<std::filesystem::path>& paths) {
+    loadClock.restart();
+
+    for (const auto& path : paths) {
+        const std::string key = keyOf(path);
+        if (findJob(key)) continue;
+
+        auto job = std::make_unique<Job>();
+        job->key = key;
+        job->path = path;
+        job->kind = path.extension() == ".wav" ? Kind::Sound : Kind::Image;
+        jobs.push_back(std::move(job));
+    }
+
+    nextJob = 0;
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    const unsigned int workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.emplace_back(work);
+    }
+}
+
+// Worker threads: CPU decoding only, no GL calls
+void AssetLoader::work() {
+    for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+        Job& job = *jobs[i];
+        sf::Clock clock;
+        if (job.kind == Kind::Image) {
+            job.failed = !job.image.loadFromFile(job.path);
+        } else {
+            job.sound = std::make_shared<sf::SoundBuffer>();
+            job.failed = !job.sound->loadFromFile(job.path);
+        }
+        job.decodeMs = clock.getElapsedTime().asSeconds() * 1000.f;
+        job.decoded.store(true, std::memory_order_release);
+    }
+}
+
+// Main thread: GPU upload and publication
+void AssetLoader::finish(Job& job) {
+    job.finished = true;
+    finishedCount++;
+
+    if (job.failed) {
+        std::cerr << "Erreur: impossible de charger " << job.key << "\n";
+        return;
+    }
+
+    sf::Clock clock;
+    if (job.kind == Kind::Image) {
+        auto texture = std::make_shared<sf::Texture>();
+        if (!texture->loadFromImage(job.image)) {
+            std::cerr << "Erreur: impossible de creer la texture " << job.key << "\n";
+            return;
+        }
+        textures[job.key] = texture;
+        job.image = sf::Image();
+    } else {
+        sounds[job.key] = job.sound;
+        job.sound.reset();
+    }
+
+    std::cout << "Chargement: " << job.key << " decode " << job.decodeMs << " ms, upload "
+        << clock.getElapsedTime().asSeconds() * 1000.f << " ms\n";
+}
+
+void AssetLoader::poll() {
+    for (auto& job : jobs) {
+        if (!job->finished && job->decoded.load(std::memory_order_acquire)) finish(*job);
+    }
+
+    if (isDone() && !workers.empty()) {
+        shutdown();
+        std::cout << "Chargement: " << jobs.size() << " assets en " << loadClock.getElapsedTime().asMilliseconds() << " ms\n";
+    }
+}
+
+void AssetLoader::shutdown() {
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+}
+
+bool AssetLoader::isDone() {
+    return finishedCount == jobs.size();
+}
+
+float AssetLoader::getProgress() {
+    if (jobs.empty()) return 1.f;
+    return static_cast<float>(finishedCount) / static_cast<float>(jobs.size());
+}
+
+AssetLoader::Job* AssetLoader::findJob(const std::string& key) {
+    for (auto& job : jobs) {
+        if (job->key == key) return job.get();
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const sf::Texture> AssetLoader::getTexture(const std::filesystem::path& path) {
+    const std::string key = keyOf(path);
+    if (auto it = textures.find(key); it != textures.end()) return it->second;
+
+    if (Job* job = findJob(key); job && !job->finished) {
+        while (!job->decoded.load(std::memory_order_acquire)) std::this_thread::yield();
+        finish(*job);
+        if (auto it = textures.find(key); it != textures.end()) return it->second;
+    }
+
+    auto texture = std::make_shared<sf::Texture>();
+    if (!texture->loadFromFile(path)) {
+        throw std::runtime_error("Impossible de charger " + path.string());
+    }
+    textures[key] = texture;
+    return texture;
+}
+
+std::shared_ptr<const sf::SoundBuffer> AssetLoader::getSoundBuffer(const std::filesystem::path& path) {
+    const std::string key = keyOf(path);
+    if (auto it = sounds.find(key); it != sounds.end()) return it->second;
+
+    if (Job* job = findJob(key); job && !job->finished) {
+        while (!job->decoded.load(std::memory_order_acquire)) std::this_thread::yield();
+        finish(*job);
+        if (auto it = sounds.find(key); it != sounds.end()) return it->second;
+    }
+
+    auto sound = std::make_shared<sf::SoundBuffer>();
+    if (!sound->loadFromFile(path)) {
+        throw std::runtime_error("Impossible de charger " + path.string());
+    }
+    sounds[key] = sound;
+    return sound;
+}
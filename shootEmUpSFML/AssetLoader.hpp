@@ -0,0 +1,59 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+// Decodes the listed images and sounds on a pool of worker threads.
+// Textures are uploaded on the main thread from poll(); anything requested
+// before it is ready is waited for, and anything never queued is loaded on the spot.
+class AssetLoader {
+public:
+    // .wav files are decoded as sounds, everything else as images
+    static void start(const std::vector<std::filesystem::path>& paths);
+    static void poll();
+    static void shutdown();
+
+    static bool isDone();
+    static float getProgress();
+
+    static std::shared_ptr<const sf::Texture> getTexture(const std::filesystem::path& path);
+    static std::shared_ptr<const sf::SoundBuffer> getSoundBuffer(const std::filesystem::path& path);
+
+private:
+    enum class Kind {
+        Image,
+        Sound
+    };
+
+    struct Job {
+        std::string key;
+        std::filesystem::path path;
+        Kind kind = Kind::Image;
+
+        sf::Image image;
+        std::shared_ptr<sf::SoundBuffer> sound;
+        float decodeMs = 0.f;
+        bool failed = false;
+        std::atomic<bool> decoded{ false };
+        bool finished = false;
+    };
+
+    static std::string keyOf(const std::filesystem::path& path);
+    static void work();
+    static void finish(Job& job);
+    static Job* findJob(const std::string& key);
+
+    static std::vector<std::unique_ptr<Job>> jobs;
+    static std::atomic<std::size_t> nextJob;
+    static std::vector<std::thread> workers;
+    static std::size_t finishedCount;
+
+    static std::unordered_map<std::string, std::shared_ptr<sf::Texture>> textures;
+    static std::unordered_map<std::string, std::shared_ptr<sf::SoundBuffer>> sounds;
+};
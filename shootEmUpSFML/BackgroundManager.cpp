@@ -1,47 +1,165 @@
 #include "BackgroundManager.hpp"
+#include "AssetLoader.hpp"
+#include <cmath>
+#include <iostream>
 
-void BackgroundManager::addBackground(const std::string& path, int frameCount, float frameDelay, float scrollSpeed, std::uint8_t alpha) {
-    auto sprite1 = std::make_shared<SpriteWrapper>(path);
-    auto sprite2 = std::make_shared<SpriteWrapper>(path);
+std::size_t BackgroundManager::addLayer(const std::string& path, int frameCount, float frameDelay, float scrollSpeed, std::uint8_t alpha) {
+    Layer layer;
+    layer.texture = AssetLoader::getTexture(path);
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < frameCount; ++i) {
-        frames.push_back(Frame{ sf::IntRect({i * 1280, 0}, {1280, 720}) });
-    }
+    const sf::Vector2i textureSize(layer.texture->getSize());
+    const sf::Vector2i frameSize(textureSize.x / frameCount, textureSize.y);
+
+    layer.anim = std::make_shared<Animation>(Strip::row(frameSize, frameCount), frameDelay);
+    layer.frameDelay = frameDelay;
+    layer.scrollSpeed = scrollSpeed;
+    layer.color = sf::Color(255, 255, 255, alpha);
+    buildQuads(layer.vertices, layer.anim->getFirstRect(), layer.offset, layer.color);
 
-    auto anim = std::make_shared<Animation>(frames, frameDelay);
+    m_layers.push_back(layer);
+    setCached(m_cached);
+    return m_layers.size() - 1;
+}
 
-    sprite1->setRect(anim->getRect());
-    sprite2->setRect(anim->getRect());
+void BackgroundManager::setScrollSpeed(std::size_t layer, float scrollSpeed) {
+    m_layers[layer].scrollSpeed = scrollSpeed;
+}
 
-    sprite1->get().setColor(sf::Color(255,255,255,alpha));
-    sprite2->get().setColor(sf::Color(255,255,255,alpha));
+void BackgroundManager::setAlpha(std::size_t layer, std::uint8_t alpha) {
+    m_layers[layer].color.a = alpha;
+    m_cacheKey.clear();
+}
 
-    m_layers.push_back({ sprite1, sprite2, anim, scrollSpeed, 0.f, -720.f, alpha });
+std::size_t BackgroundManager::getLayerCount() const {
+    return m_layers.size();
 }
 
 void BackgroundManager::update(float dt) {
-    for (auto& layer : m_layers) {
-        layer.anim->update(dt);
-        layer.sprite1->setRect(layer.anim->getRect());
-        layer.sprite2->setRect(layer.anim->getRect());
+    m_blendedPixels = 0;
+    for (std::size_t i = 0; i < m_layers.size(); i++) {
+        auto& layer = m_layers[i];
+        if (m_animated) {
+            layer.elapsed += dt;
+            layer.frame = layer.anim->getIndex(layer.elapsed);
+        }
+
+        const sf::IntRect& rect = layer.anim->getRect(layer.frame);
+        layer.offset = std::fmod(layer.offset + layer.scrollSpeed * dt, static_cast<float>(rect.size.y));
+
+        if (i >= m_cachedCount) {
+            buildQuads(layer.vertices, rect, layer.offset, layer.color);
+            m_blendedPixels += static_cast<std::size_t>(rect.size.x) * static_cast<std::size_t>(rect.size.y);
+        }
+    }
+
+    if (m_cachedCount > 0) updateCache();
+}
+
+void BackgroundManager::setAnimated(bool animated) {
+    m_animated = animated;
+}
+
+void BackgroundManager::setCached(bool cached) {
+    m_cached = cached;
+    m_cachedCount = 0;
+    m_cacheKey.clear();
+    m_cacheFrames = 0;
+    m_cacheRedraws = 0;
+    if (!cached || m_layers.empty()) return;
+
+    // bottom layers only, with slow frames and the size of the first one
+    const sf::Vector2i size = m_layers[0].anim->getFirstRect().size;
+    while (m_cachedCount < m_layers.size()
+        && m_layers[m_cachedCount].frameDelay >= minCachedFrameDelay
+        && m_layers[m_cachedCount].anim->getFirstRect().size == size) {
+        m_cachedCount++;
+    }
+    if (m_cachedCount == 0) return;
+
+    if (m_cache.getSize() != sf::Vector2u(size) && !m_cache.resize(sf::Vector2u(size))) {
+        std::cerr << "Erreur: impossible de creer le cache du fond\n";
+        m_cachedCount = 0;
+    }
+}
+
+float BackgroundManager::getCacheHitRate() const {
+    if (m_cacheFrames == 0) return 0.f;
+    return static_cast<float>(m_cacheFrames - m_cacheRedraws) / static_cast<float>(m_cacheFrames);
+}
+
+std::size_t BackgroundManager::getBlendedPixels() const {
+    return m_blendedPixels;
+}
+
+// Key: frame index and scroll relative to the first layer, in whole pixels, of every cached layer
+void BackgroundManager::updateCache() {
+    const Layer& first = m_layers[0];
+    const sf::IntRect& firstRect = first.anim->getRect(first.frame);
+    const float height = static_cast<float>(firstRect.size.y);
+
+    m_nextCacheKey.clear();
+    for (std::size_t i = 0; i < m_cachedCount; i++) {
+        const Layer& layer = m_layers[i];
+        m_nextCacheKey.push_back(static_cast<int>(layer.frame));
+        m_nextCacheKey.push_back(static_cast<int>(std::fmod(layer.offset - first.offset + height, height)));
+    }
 
-        layer.y1 += layer.scrollSpeed * dt;
-        layer.y2 += layer.scrollSpeed * dt;
+    m_cacheFrames++;
+    if (m_nextCacheKey != m_cacheKey) {
+        m_cacheKey.swap(m_nextCacheKey);
+        m_cacheRedraws++;
 
-        if (layer.y1 >= 720.f) layer.y1 = layer.y2 - 720.f;
-        if (layer.y2 >= 720.f) layer.y2 = layer.y1 - 720.f;
+        m_cache.clear(sf::Color::Black);
+        Quads quads;
+        for (std::size_t i = 0; i < m_cachedCount; i++) {
+            const Layer& layer = m_layers[i];
+            buildQuads(quads, layer.anim->getRect(layer.frame), static_cast<float>(m_cacheKey[i * 2 + 1]), layer.color);
+            sf::RenderStates states;
+            states.texture = layer.texture.get();
+            m_cache.draw(quads.data(), quads.size(), sf::PrimitiveType::Triangles, states);
+            m_blendedPixels += static_cast<std::size_t>(firstRect.size.x) * static_cast<std::size_t>(firstRect.size.y);
+        }
+        m_cache.display();
     }
+
+    buildQuads(m_cacheVertices, sf::IntRect({ 0, 0 }, firstRect.size), first.offset, sf::Color::White);
+}
+
+// The frame scrolled down by `offset`: its bottom rows on top of the screen, then the rest
+void BackgroundManager::buildQuads(Quads& quads, const sf::IntRect& rect, float offset, sf::Color color) {
+    const float left = static_cast<float>(rect.position.x);
+    const float top = static_cast<float>(rect.position.y);
+    const float width = static_cast<float>(rect.size.x);
+    const float height = static_cast<float>(rect.size.y);
+    const float split = height - offset;
+
+    auto quad = [&](sf::Vertex* v, float screenTop, float screenBottom, float texTop, float texBottom) {
+        const sf::Vertex tl{ { 0.f, screenTop }, color, { left, texTop } };
+        const sf::Vertex tr{ { width, screenTop }, color, { left + width, texTop } };
+        const sf::Vertex bl{ { 0.f, screenBottom }, color, { left, texBottom } };
+        const sf::Vertex br{ { width, screenBottom }, color, { left + width, texBottom } };
+        v[0] = tl; v[1] = tr; v[2] = bl;
+        v[3] = bl; v[4] = tr; v[5] = br;
+    };
+
+    quad(&quads[0], 0.f, offset, top + split, top + height);
+    quad(&quads[6], offset, height, top, top + split);
 }
 
 void BackgroundManager::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    for (const auto& layer : m_layers) {
-        auto spr1 = layer.sprite1->get();
-        spr1.setPosition({ 0.f, layer.y1 });
-        target.draw(spr1, states);
-
-        auto spr2 = layer.sprite2->get();
-        spr2.setPosition({ 0.f, layer.y2 });
-        target.draw(spr2, states);
+    std::size_t first = 0;
+    if (m_cachedCount > 0) {
+        // the cache already holds the black clear, nothing to blend with
+        sf::RenderStates cacheStates = states;
+        cacheStates.texture = &m_cache.getTexture();
+        cacheStates.blendMode = sf::BlendNone;
+        target.draw(m_cacheVertices.data(), m_cacheVertices.size(), sf::PrimitiveType::Triangles, cacheStates);
+        first = m_cachedCount;
+    }
+
+    for (std::size_t i = first; i < m_layers.size(); i++) {
+        const Layer& layer = m_layers[i];
+        states.texture = layer.texture.get();
+        target.draw(layer.vertices.data(), layer.vertices.size(), sf::PrimitiveType::Triangles, states);
     }
 }
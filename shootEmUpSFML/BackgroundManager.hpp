@@ -1,28 +1,71 @@
 #pragma once
 #include "SpriteComposite.hpp"
+#include <array>
 #include <memory>
 #include <vector>
 #include <SFML/Graphics.hpp>
 #include <cstdint>
 
+// Parallax layers drawn back to front. Each layer is one horizontal strip of
+// animation frames, loaded once and scrolled vertically through its texture
+// coordinates: the wrap point splits the frame into two quads that go out in
+// a single draw call.
+//
+// With caching on, the bottom layers whose frames change slowly are composed
+// over black into a render texture, redrawn only when one of their frames or
+// their scroll relative to each other changes. The cache is drawn opaque at
+// the first layer's offset, so those layers cost one unblended fill.
 class BackgroundManager : public sf::Drawable {
 public:
-    void addBackground(const std::string& path, int frameCount, float frameDelay, float scrollSpeed, std::uint8_t alpha = 255);
+    // Frames are texture width / frameCount wide and as tall as the texture. Returns the layer index.
+    std::size_t addLayer(const std::string& path, int frameCount, float frameDelay, float scrollSpeed, std::uint8_t alpha = 255);
+
+    void setScrollSpeed(std::size_t layer, float scrollSpeed);
+    void setAlpha(std::size_t layer, std::uint8_t alpha);
+    std::size_t getLayerCount() const;
 
     void update(float dt);
+    // false freezes the frame animation, scrolling continues
+    void setAnimated(bool animated);
+
+    void setCached(bool cached);
+    // Frames drawn from the cache without redrawing it, since setCached
+    float getCacheHitRate() const;
+    // Pixels alpha-blended by the last update + draw, cache redraws included
+    std::size_t getBlendedPixels() const;
 
 private:
+    using Quads = std::array<sf::Vertex, 12>;
+
+    static constexpr float minCachedFrameDelay = 0.1f;
+
     struct Layer {
-        std::shared_ptr<SpriteWrapper> sprite1;
-        std::shared_ptr<SpriteWrapper> sprite2;
+        std::shared_ptr<const sf::Texture> texture;
         std::shared_ptr<Animation> anim;
+        double elapsed = 0.0;
+        std::size_t frame = 0;
+        float frameDelay = 0.f;
         float scrollSpeed = 0.f;
-        float y1 = 0.f;
-        float y2 = -720.f; 
-        std::uint8_t alpha = 255;
+        float offset = 0.f;
+        sf::Color color = sf::Color::White;
+        Quads vertices{};
     };
 
+    static void buildQuads(Quads& quads, const sf::IntRect& rect, float offset, sf::Color color);
+    void updateCache();
+
     std::vector<Layer> m_layers;
+    bool m_animated = true;
+
+    bool m_cached = false;
+    std::size_t m_cachedCount = 0;
+    sf::RenderTexture m_cache;
+    Quads m_cacheVertices{};
+    std::vector<int> m_cacheKey;
+    std::vector<int> m_nextCacheKey;
+    std::size_t m_cacheFrames = 0;
+    std::size_t m_cacheRedraws = 0;
+    std::size_t m_blendedPixels = 0;
 
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 };
@@ -0,0 +1,444 @@
+#include "Benchmark.hpp"
+#include "BulletRenderer.hpp"
+#include "RenderQueue.hpp"
+#include "Pool.hpp"
+#include "BulletScript.hpp"
+#include "CommandBuffer.hpp"
+#include "EventStream.hpp"
+#include "TimerWheel.hpp"
+#include "BackgroundManager.hpp"
+#include "randomGenerator.hpp"
+#include <iostream>
+#include <functional>
+#include <memory>
+
+namespace {
+    // Runs `drawFrame` into the target and returns the mean time per frame in ms,
+    // reading the result back at the end so queued GPU work is included.
+    float timeFrames(sf::RenderTexture& target, int frames, const std::function<void()>& drawFrame) {
+        target.clear();
+        drawFrame();
+        target.display();
+
+        sf::Clock clock;
+        for (int i = 0; i < frames; i++) {
+            target.clear();
+            drawFrame();
+            target.display();
+        }
+        sf::Image sync = target.getTexture().copyToImage();
+        return clock.getElapsedTime().asSeconds() * 1000.f / static_cast<float>(frames);
+    }
+
+    // Field order and sizes of Entity before the hot records moved into the pools, with the
+    // SpriteComposite of that time inlined. Only update() and the box test are reproduced.
+    struct LegacyEntity : sf::Drawable {
+        struct Child {
+            std::shared_ptr<SpriteWrapper> sprite;
+            std::shared_ptr<Animation> anim;
+            sf::Vector2f offset{ 0.f, 0.f };
+            bool visible = true;
+            bool animActive = true;
+            bool stopAfterCurrentLoop = false;
+            bool stopAfterCurrentLoopVisibleToggle = false;
+        };
+        struct Composite : sf::Drawable, sf::Transformable {
+            bool flipX = false;
+            bool flipY = false;
+            std::vector<Child> children;
+            void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+        };
+        enum class Type { Player, Enemy };
+
+        std::shared_ptr<Pool> bulletPool;
+        std::shared_ptr<Pool> destructionPool;
+        Composite composite;
+        sf::FloatRect hitbox{};
+        sf::Vector2f hitboxOffset{ 0.f, 0.f };
+        sf::FloatRect hurtbox{};
+        sf::Vector2f hurtboxOffset{ 0.f, 0.f };
+        sf::Vector2f velocity;
+        std::function<void(LegacyEntity&, float, PatternState&)> pattern;
+        PatternState patternState;
+        std::function<void(LegacyEntity&, Pool&, float)> bulletSpawner;
+        float lastFire = 0.f;
+        float fireRate = 0.f;
+        Type type = Type::Enemy;
+        int health = 1;
+        int initHealth = 1;
+        int damage = 0;
+        bool actived = false;
+        bool desactivateAfterAnimation = false;
+        int score = 0;
+
+        // Animations are clock driven now, so the composite update of that time is left out
+        void update(float dt) {
+            if (pattern) pattern(*this, dt, patternState);
+            if (bulletSpawner) {
+                lastFire += dt;
+                if (lastFire >= fireRate) {
+                    lastFire = 0.f;
+                    bulletSpawner(*this, *bulletPool, dt);
+                }
+            }
+            // isAnimationGoing() was only reached for effects
+            if (desactivateAfterAnimation) actived = false;
+
+            hitbox.position = composite.getPosition() + hitboxOffset;
+            hurtbox.position = composite.getPosition() + hurtboxOffset;
+        }
+
+        void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+    };
+}
+
+namespace Benchmark {
+
+    void run() {
+        bulletRendering();
+        bulletEmitters();
+        restart();
+        background();
+        entityLayout();
+        timers();
+    }
+
+    void bulletRendering(std::size_t bulletCount, int frames) {
+        sf::RenderTexture target;
+        if (!target.resize({ 1280, 720 })) {
+            std::cerr << "Erreur: impossible de creer la cible de rendu\n";
+            return;
+        }
+
+        EntityConfig config("assets/config/entities.cfg");
+        auto bulletSprite = PoolManager::createSprite(config, config.findSprite("fighterBullet"));
+        auto child = bulletSprite->getChild(0);
+        const sf::Texture& texture = child.sprite->get().getTexture();
+        const Strip& strip = child.anim->getStrip();
+
+        std::vector<sf::Vector2f> positions;
+        std::vector<SpriteComposite> composites;
+        positions.reserve(bulletCount);
+        composites.reserve(bulletCount);
+        for (std::size_t i = 0; i < bulletCount; i++) {
+            positions.push_back({ RandomGenerator::getFloat(0.f, 1272.f), RandomGenerator::getFloat(0.f, 712.f) });
+            composites.push_back(*bulletSprite);
+            composites.back().setPosition(positions.back());
+        }
+
+        std::cout << "Bullet rendering, " << bulletCount << " bullets, " << frames << " frames\n";
+
+        RenderQueue queue;
+        float spriteMs = timeFrames(target, frames, [&]() {
+            queue.begin(target.getView());
+            for (auto& comp : composites) comp.submit(queue, RenderLayer::EnemyBullets);
+            queue.flush(target);
+        });
+        std::cout << "  composite + render queue : " << spriteMs << " ms/frame\n";
+
+        auto timeRenderer = [&](BulletRenderer& renderer) {
+            return timeFrames(target, frames, [&]() {
+                renderer.begin(texture, strip, bulletSprite->getFlipX(), bulletSprite->getFlipY());
+                for (std::size_t i = 0; i < positions.size(); i++) renderer.add(positions[i], i % static_cast<std::size_t>(strip.count));
+                renderer.end(target);
+            });
+        };
+
+        BulletRenderer cpuRenderer(false);
+        std::cout << "  bullet renderer (CPU)    : " << timeRenderer(cpuRenderer) << " ms/frame, "
+            << cpuRenderer.getUploadedBytes() / bulletCount << " B/bullet\n";
+
+        BulletRenderer shaderRenderer(true);
+        if (shaderRenderer.usesShader()) {
+            std::cout << "  bullet renderer (shader) : " << timeRenderer(shaderRenderer) << " ms/frame, "
+                << shaderRenderer.getUploadedBytes() / bulletCount << " B/bullet\n";
+        } else {
+            std::cout << "  bullet renderer (shader) : geometry shaders unavailable\n";
+        }
+    }
+
+    // Scripted emitters at a fixed 60 Hz step: VM recording spawns, the batched apply, then the pool update that moves the bullets
+    void bulletEmitters(std::size_t emitterCount, int frames) {
+        EntityConfig config("assets/config/entities.cfg");
+        BulletPool bullets(
+            4096,
+            Entity::Type::Enemy,
+            PoolManager::createSprite(config, config.findSprite("fighterBullet")),
+            MovementPatterns::linearAngleDirection(300.f)
+        );
+        bullets.setGrowth(1024, 65536);
+
+        auto program = std::make_shared<const BulletProgram>(
+            BulletProgram::compile("aim; spread 5 0 40; base 0; ring 16; rotate 11; wait 0.1"));
+
+        std::vector<BulletEmitter> emitters(emitterCount);
+        std::vector<sf::Vector2f> origins;
+        origins.reserve(emitterCount);
+        for (auto& emitter : emitters) {
+            emitter.start(program, 0.f);
+            origins.push_back({ RandomGenerator::getFloat(0.f, 1280.f), RandomGenerator::getFloat(0.f, 360.f) });
+        }
+        BulletEmitter::setTarget({ 640.f, 680.f });
+
+        const float dt = 1.f / 60.f;
+        CommandBuffer commands;
+        EventStream events;
+        std::size_t emitted = 0;
+        float emitMs = 0.f;
+        float applyMs = 0.f;
+        float updateMs = 0.f;
+        sf::Clock clock;
+        for (int frame = 0; frame < frames; frame++) {
+            clock.restart();
+            for (std::size_t i = 0; i < emitters.size(); i++) {
+                emitters[i].update(origins[i], bullets, commands, events, dt);
+            }
+            emitMs += clock.getElapsedTime().asSeconds() * 1000.f;
+
+            clock.restart();
+            emitted += commands.apply();
+            events.clear();
+            applyMs += clock.getElapsedTime().asSeconds() * 1000.f;
+
+            clock.restart();
+            bullets.update(dt, commands, events);
+            updateMs += clock.getElapsedTime().asSeconds() * 1000.f;
+        }
+
+        const float simulated = dt * static_cast<float>(frames);
+        std::cout << "Bullet emitters, " << emitterCount << " emitters, " << frames << " frames\n";
+        std::cout << "  emitted                  : " << static_cast<float>(emitted) / simulated << " bullets/s, peak "
+            << bullets.getHighWater() << " active, " << bullets.getSpawnFailures() << " failures\n";
+        std::cout << "  emitters                 : " << emitMs / static_cast<float>(frames) << " ms/frame\n";
+        std::cout << "  command apply            : " << applyMs / static_cast<float>(frames) << " ms/frame\n";
+        std::cout << "  pool update              : " << updateMs / static_cast<float>(frames) << " ms/frame\n";
+    }
+
+    // Cost of going back to Playing: rebuilding the PoolManager (what main used to do) vs resetting it in place
+    void restart(int restarts) {
+        EntityConfig config("assets/config/entities.cfg");
+
+        sf::Clock clock;
+        PoolManager pools(config);
+        std::cout << "Restart, " << restarts << " restarts\n";
+        std::cout << "  first construction       : " << clock.getElapsedTime().asSeconds() * 1000.f << " ms\n";
+
+        auto fill = [&]() {
+            for (auto& type : pools.enemies) {
+                for (int i = 0; i < 32; i++) type.ship->spawn({ 100.f, 100.f });
+                for (int i = 0; type.bullet && i < 256; i++) type.bullet->spawn({ 100.f, 100.f });
+            }
+        };
+
+        float rebuildMs = 0.f;
+        for (int i = 0; i < restarts; i++) {
+            fill();
+            clock.restart();
+            pools = PoolManager(config);
+            rebuildMs += clock.getElapsedTime().asSeconds() * 1000.f;
+        }
+        std::cout << "  PoolManager(config)      : " << rebuildMs / static_cast<float>(restarts) << " ms/restart\n";
+
+        float resetMs = 0.f;
+        for (int i = 0; i < restarts; i++) {
+            fill();
+            clock.restart();
+            pools.reset();
+            resetMs += clock.getElapsedTime().asSeconds() * 1000.f;
+        }
+        std::cout << "  PoolManager::reset()     : " << resetMs / static_cast<float>(restarts) << " ms/restart\n";
+    }
+
+    // The game's two layers at 60 Hz, every layer blended live vs the slow ones cached
+    void background(int frames) {
+        sf::RenderTexture target;
+        if (!target.resize({ 1280, 720 })) {
+            std::cerr << "Erreur: impossible de creer la cible de rendu\n";
+            return;
+        }
+
+        std::cout << "Background, " << frames << " frames\n";
+
+        auto measure = [&](bool cached, bool animated) {
+            BackgroundManager background;
+            background.addLayer("assets/background/bg1.png", 9, 2.f, 5.f, 100);
+            background.addLayer("assets/background/bg2.png", 9, 0.01f, 25.f, 150);
+            background.setCached(cached);
+            background.setAnimated(animated);
+
+            std::size_t blended = 0;
+            const float ms = timeFrames(target, frames, [&]() {
+                background.update(1.f / 60.f);
+                target.draw(background);
+                blended += background.getBlendedPixels();
+            });
+            const char* label = cached ? (animated ? "  cached                   : " : "  cached, frames frozen    : ") : "  uncached                 : ";
+            std::cout << label << ms << " ms/frame, " << blended / static_cast<std::size_t>(frames + 1) << " blended px/frame";
+            if (cached) std::cout << ", cache hit rate " << background.getCacheHitRate() * 100.f << "%";
+            std::cout << "\n";
+        };
+
+        measure(false, true);
+        measure(true, true);
+        measure(true, false);
+    }
+
+    // The same update and collision loops over the Entity as it was before the per-pool hot
+    // vectors (LegacyEntity, one heap object per entity) and over the current pools
+    void entityLayout(std::size_t entityCount, int frames) {
+        EntityConfig config("assets/config/entities.cfg");
+        const auto sprite = PoolManager::createSprite(config, config.findSprite("fighterBullet"));
+        const MovementPattern pattern = MovementPatterns::linearAngleDirection(10.f);
+        const sf::Vector2f hitbox{ 32.f, 32.f };
+        const sf::Vector2f hurtbox{ 9.f, 12.f };
+        const sf::Vector2f playerPos{ 640.f, 600.f };
+
+        std::vector<sf::Vector2f> positions(entityCount);
+        for (auto& position : positions) position = { RandomGenerator::getFloat(0.f, 1272.f), RandomGenerator::getFloat(0.f, 712.f) };
+
+        const float dt = 1.f / 60.f;
+        std::cout << "Entity layout, " << entityCount << " entities, " << frames << " frames\n";
+
+        // Before: Pool::update called Entity::update on each active entity through its shared_ptr,
+        // the pattern moved the composite and the boxes were recomputed from it
+        {
+            auto makeEntity = [&](const sf::Vector2f& position) {
+                auto e = std::make_shared<LegacyEntity>();
+                e->composite.children.resize(sprite->getChildrenCount());
+                e->composite.setPosition(position);
+                e->hitbox.size = hitbox;
+                e->hurtbox.size = hurtbox;
+                e->pattern = [&pattern](LegacyEntity& self, float dt, PatternState& state) {
+                    sf::Vector2f position = self.composite.getPosition();
+                    pattern(position, dt, state);
+                    self.composite.setPosition(position);
+                };
+                e->actived = true;
+                return e;
+            };
+            std::vector<std::shared_ptr<LegacyEntity>> bullets;
+            bullets.reserve(entityCount);
+            for (const auto& position : positions) bullets.push_back(makeEntity(position));
+            std::vector<std::shared_ptr<LegacyEntity>> players{ makeEntity(playerPos) };
+
+            std::size_t hits = 0;
+            float updateMs = 0.f;
+            float collisionMs = 0.f;
+            sf::Clock clock;
+            for (int frame = 0; frame < frames; frame++) {
+                clock.restart();
+                for (auto& pool : { &players, &bullets }) {
+                    for (auto& obj : *pool) {
+                        if (!obj->actived) continue;
+                        obj->update(dt);
+                        const sf::Vector2f position = obj->composite.getPosition();
+                        if (position.y < -200.f || position.y > 920.f || position.x < -200.f || position.x > 1480.f) obj->actived = false;
+                    }
+                }
+                updateMs += clock.getElapsedTime().asSeconds() * 1000.f;
+
+                clock.restart();
+                for (auto& player : players) {
+                    if (!player->actived) continue;
+                    for (auto& proj : bullets) {
+                        if (proj->actived && player->hitbox.findIntersection(proj->hurtbox)) hits++;
+                    }
+                }
+                collisionMs += clock.getElapsedTime().asSeconds() * 1000.f;
+            }
+
+            // from the composite to the last field, everything update reads
+            const LegacyEntity& e = *bullets.front();
+            const auto touched = reinterpret_cast<const char*>(&e.score + 1) - reinterpret_cast<const char*>(&e.composite);
+            const float perEntity = 1e6f / static_cast<float>(frames) / static_cast<float>(entityCount);
+            std::cout << "  before                   : sizeof(Entity) " << sizeof(LegacyEntity) << " bytes, " << touched << " bytes touched per entity\n";
+            std::cout << "    update                 : " << updateMs * perEntity << " ns/entity\n";
+            std::cout << "    collision              : " << collisionMs * perEntity << " ns/entity (" << hits << " hits)\n";
+        }
+
+        // After: the pool update walks the hot vector, collisions go through Entity handles
+        {
+            BulletPool bullets(entityCount, Entity::Type::Enemy, sprite, pattern, nullptr, { 0.f, 0.f }, hurtbox);
+            BulletPool players(1, Entity::Type::Player, sprite, pattern, nullptr, hitbox);
+            const std::vector<PatternState> states(entityCount);
+            bullets.spawnBatch(positions.data(), states.data(), entityCount);
+            players.spawn(playerPos);
+
+            CommandBuffer commands;
+            EventStream events;
+            std::size_t hits = 0;
+            float updateMs = 0.f;
+            float collisionMs = 0.f;
+            sf::Clock clock;
+            for (int frame = 0; frame < frames; frame++) {
+                clock.restart();
+                players.update(dt, commands, events);
+                bullets.update(dt, commands, events);
+                updateMs += clock.getElapsedTime().asSeconds() * 1000.f;
+
+                clock.restart();
+                players.forEachActive([&](Entity player) {
+                    bullets.forEachActive([&](Entity proj) {
+                        if (player.hurtBy(proj)) hits++;
+                    });
+                });
+                collisionMs += clock.getElapsedTime().asSeconds() * 1000.f;
+            }
+
+            const float perEntity = 1e6f / static_cast<float>(frames) / static_cast<float>(entityCount);
+            std::cout << "  after                    : sizeof(Entity::Hot) " << sizeof(Entity::Hot) << " bytes touched per entity, plus its active bit\n";
+            std::cout << "    update                 : " << updateMs * perEntity << " ns/entity\n";
+            std::cout << "    collision              : " << collisionMs * perEntity << " ns/entity (" << hits << " hits)\n";
+        }
+    }
+
+    // Periodic timers with fire-rate-like periods at 60 Hz: counting every one down each
+    // frame, as emitters used to, vs the timer wheel, which only touches the due ones
+    void timers(std::size_t timerCount, int frames) {
+        std::vector<float> periods(timerCount);
+        for (auto& period : periods) period = RandomGenerator::getFloat(0.1f, 3.f);
+
+        const float dt = 1.f / 60.f;
+        std::cout << "Timers, " << timerCount << " live, " << frames << " frames\n";
+
+        std::vector<float> remaining(periods);
+        std::size_t polled = 0;
+        sf::Clock clock;
+        for (int frame = 0; frame < frames; frame++) {
+            for (std::size_t i = 0; i < timerCount; i++) {
+                remaining[i] -= dt;
+                if (remaining[i] > 0.f) continue;
+                remaining[i] += periods[i];
+                polled++;
+            }
+        }
+        const float pollMs = clock.getElapsedTime().asSeconds() * 1000.f / static_cast<float>(frames);
+        std::cout << "  polled every frame       : " << pollMs << " ms/frame, " << polled / static_cast<std::size_t>(frames) << " due/frame\n";
+
+        TimerWheel wheel;
+        for (std::size_t i = 0; i < timerCount; i++) wheel.schedule(periods[i], static_cast<std::uint32_t>(i));
+        std::size_t fired = 0;
+        clock.restart();
+        for (int frame = 0; frame < frames; frame++) {
+            wheel.advance(dt, [&](std::uint32_t id) {
+                wheel.schedule(periods[id], id);
+                fired++;
+            });
+        }
+        const float wheelMs = clock.getElapsedTime().asSeconds() * 1000.f / static_cast<float>(frames);
+        std::cout << "  timer wheel              : " << wheelMs << " ms/frame, " << fired / static_cast<std::size_t>(frames) << " due/frame\n";
+
+        // every live timer cancelled and scheduled again, as spawns and kills do
+        std::vector<TimerWheel::Handle> handles(timerCount);
+        wheel.clear();
+        for (std::size_t i = 0; i < timerCount; i++) handles[i] = wheel.schedule(periods[i], static_cast<std::uint32_t>(i));
+        clock.restart();
+        for (int round = 0; round < 16; round++) {
+            for (std::size_t i = 0; i < timerCount; i++) {
+                wheel.cancel(handles[i]);
+                handles[i] = wheel.schedule(periods[i], static_cast<std::uint32_t>(i));
+            }
+        }
+        std::cout << "  cancel + schedule        : " << clock.getElapsedTime().asSeconds() * 1e9f / static_cast<float>(16 * timerCount) << " ns/timer\n";
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+
+// Offscreen measurements, run with `shootEmUpSFML --benchmark` from the game directory.
+namespace Benchmark {
+    void run();
+
+    void bulletRendering(std::size_t bulletCount = 10000, int frames = 100);
+    void bulletEmitters(std::size_t emitterCount = 50, int frames = 600);
+    void restart(int restarts = 20);
+    void background(int frames = 600);
+    void entityLayout(std::size_t entityCount = 4096, int frames = 200);
+    void timers(std::size_t timerCount = 8192, int frames = 600);
+}
@@ -0,0 +1,150 @@
+#include "BulletRenderer.hpp"
+#include <iostream>
+
+namespace {
+    // One point per bullet: its position, and its frame index in texCoords.x
+    constexpr const char* vertexShader = R"(
+#version 150 compatibility
+
+out float frame;
+
+void main()
+{
+    gl_Position = gl_Vertex;
+    frame = gl_MultiTexCoord0.x;
+}
+)";
+
+    // Corners in TL, TR, BL, BR order, as a triangle strip
+    constexpr const char* geometryShader = R"(
+#version 150 compatibility
+
+layout(points) in;
+layout(triangle_strip, max_vertices = 4) out;
+
+uniform vec2 stripOrigin;
+uniform vec2 stripStride;
+uniform vec2 cellSize;
+uniform vec2 textureSize;
+uniform vec2 flip;
+
+in float frame[];
+out vec2 texCoord;
+
+void main()
+{
+    vec2 position = gl_in[0].gl_Position.xy;
+    vec2 cell = stripOrigin + frame[0] * stripStride;
+
+    for (int corner = 0; corner < 4; corner++) {
+        vec2 unit = vec2(float(corner % 2), float(corner / 2));
+        gl_Position = gl_ModelViewProjectionMatrix * vec4(position + unit * cellSize, 0.0, 1.0);
+
+        vec2 uv = mix(unit, vec2(1.0) - unit, flip);
+        texCoord = (cell + uv * cellSize) / textureSize;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+)";
+
+    constexpr const char* fragmentShader = R"(
+#version 150 compatibility
+
+uniform sampler2D sheet;
+
+in vec2 texCoord;
+
+void main()
+{
+    gl_FragColor = texture2D(sheet, texCoord);
+}
+)";
+
+    constexpr int corners[6] = { 0, 1, 2, 2, 1, 3 };
+}
+
+BulletRenderer::BulletRenderer(bool useShader) {
+    if (useShader && sf::Shader::isGeometryAvailable()) {
+        if (m_shader.loadFromMemory(vertexShader, geometryShader, fragmentShader)) {
+            m_useShader = true;
+            m_useBuffer = sf::VertexBuffer::isAvailable();
+        } else {
+            std::cerr << "Erreur: shader des projectiles invalide, rendu CPU\n";
+        }
+    }
+}
+
+bool BulletRenderer::usesShader() const {
+    return m_useShader;
+}
+
+std::size_t BulletRenderer::getUploadedBytes() const {
+    return m_uploadedBytes;
+}
+
+void BulletRenderer::begin(const sf::Texture& texture, const Strip& strip, bool flipX, bool flipY) {
+    m_texture = &texture;
+    m_strip = strip;
+    m_cellSize = sf::Vector2f(strip.cellSize);
+    m_flipX = flipX;
+    m_flipY = flipY;
+    m_vertices.clear();
+}
+
+void BulletRenderer::add(sf::Vector2f position, std::size_t frame) {
+    if (m_useShader) {
+        m_vertices.push_back(sf::Vertex{ position, sf::Color::White, { static_cast<float>(frame), 0.f } });
+        return;
+    }
+
+    const sf::FloatRect rect(m_strip.getRect(frame));
+    float left = rect.position.x;
+    float top = rect.position.y;
+    float right = left + rect.size.x;
+    float bottom = top + rect.size.y;
+    if (m_flipX) std::swap(left, right);
+    if (m_flipY) std::swap(top, bottom);
+
+    const sf::Vertex quad[4] = {
+        { position, sf::Color::White, { left, top } },
+        { position + sf::Vector2f(m_cellSize.x, 0.f), sf::Color::White, { right, top } },
+        { position + sf::Vector2f(0.f, m_cellSize.y), sf::Color::White, { left, bottom } },
+        { position + m_cellSize, sf::Color::White, { right, bottom } }
+    };
+    for (int corner : corners) {
+        m_vertices.push_back(quad[corner]);
+    }
+}
+
+void BulletRenderer::end(sf::RenderTarget& target) {
+    m_uploadedBytes = 0;
+    if (m_vertices.empty() || !m_texture) return;
+    m_uploadedBytes = m_vertices.size() * sizeof(sf::Vertex);
+
+    sf::RenderStates states;
+    states.texture = m_texture;
+
+    if (!m_useShader) {
+        target.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles, states);
+        return;
+    }
+
+    m_shader.setUniform("sheet", sf::Shader::CurrentTexture);
+    m_shader.setUniform("stripOrigin", sf::Vector2f(m_strip.origin));
+    m_shader.setUniform("stripStride", sf::Vector2f(m_strip.stride));
+    m_shader.setUniform("cellSize", m_cellSize);
+    m_shader.setUniform("textureSize", sf::Vector2f(m_texture->getSize()));
+    m_shader.setUniform("flip", sf::Vector2f(m_flipX ? 1.f : 0.f, m_flipY ? 1.f : 0.f));
+    states.shader = &m_shader;
+
+    if (m_useBuffer) {
+        if (m_buffer.getVertexCount() < m_vertices.size() && !m_buffer.create(m_vertices.size() * 2)) {
+            m_useBuffer = false;
+        } else if (m_buffer.update(m_vertices.data(), m_vertices.size(), 0)) {
+            target.draw(m_buffer, 0, m_vertices.size(), states);
+            return;
+        }
+    }
+    target.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Points, states);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "SpriteComposite.hpp"
+#include <vector>
+
+// Draws every bullet of one strip texture in a single call.
+// With geometry shaders, each bullet uploads one point (its position and frame index)
+// that the geometry shader expands into a quad; otherwise the quads are built on the CPU.
+class BulletRenderer {
+public:
+    explicit BulletRenderer(bool useShader = true);
+
+    bool usesShader() const;
+    // Vertex data sent by the last end(), to compare both paths
+    std::size_t getUploadedBytes() const;
+
+    // Frames are looked up in the strip, as Animation does
+    void begin(const sf::Texture& texture, const Strip& strip, bool flipX, bool flipY);
+    void add(sf::Vector2f position, std::size_t frame);
+    void end(sf::RenderTarget& target);
+
+private:
+    sf::Shader m_shader;
+    sf::VertexBuffer m_buffer{ sf::PrimitiveType::Points, sf::VertexBuffer::Usage::Stream };
+    bool m_useShader = false;
+    bool m_useBuffer = false;
+
+    std::vector<sf::Vertex> m_vertices;
+    const sf::Texture* m_texture = nullptr;
+    Strip m_strip;
+    sf::Vector2f m_cellSize{};
+    bool m_flipX = false;
+    bool m_flipY = false;
+    std::size_t m_uploadedBytes = 0;
+};
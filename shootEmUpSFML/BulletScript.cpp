@@ -0,0 +1,251 @@
+#include "BulletScript.hpp"
+#include "Pool.hpp"
+#include "CommandBuffer.hpp"
+#include "EventStream.hpp"
+#include "SoundManager.hpp"
+#include "randomGenerator.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+// ---------------- BulletProgram ----------------
+namespace {
+    float toFloat(const std::string& text) {
+        std::size_t used = 0;
+        float value = std::stof(text, &used);
+        if (used != text.size()) throw std::invalid_argument("nombre invalide '" + text + "'");
+        return value;
+    }
+
+    std::uint16_t toCount(const std::string& text) {
+        std::size_t used = 0;
+        int value = std::stoi(text, &used);
+        if (used != text.size() || value < 1 || value > 0xFFFF) throw std::invalid_argument("nombre invalide '" + text + "'");
+        return static_cast<std::uint16_t>(value);
+    }
+
+    SoundManager::Effect toEffect(const std::string& name) {
+        if (name == "destruction") return SoundManager::Effect::Destruction;
+        if (name == "explosion") return SoundManager::Effect::Explosion;
+        if (name == "hit") return SoundManager::Effect::Hit;
+        if (name == "rocket") return SoundManager::Effect::Rocket;
+        if (name == "swoosh") return SoundManager::Effect::Swoosh;
+        throw std::invalid_argument("son inconnu '" + name + "'");
+    }
+}
+
+BulletProgram BulletProgram::compile(const std::string& source) {
+    using Op = BulletProgram::Op;
+
+    BulletProgram program;
+    std::vector<std::size_t> openLoops;
+
+    std::string lines = source;
+    for (char& c : lines) {
+        if (c == '\n') c = ';';
+    }
+
+    std::string statement;
+    std::stringstream statements(lines);
+    while (std::getline(statements, statement, ';')) {
+        std::stringstream words(statement);
+        std::vector<std::string> args;
+        for (std::string word; words >> word;) args.push_back(word);
+        if (args.empty()) continue;
+
+        const std::string name = args[0];
+        auto expect = [&](std::size_t count) {
+            if (args.size() != count + 1) {
+                throw std::invalid_argument(name + " attend " + std::to_string(count) + " parametres");
+            }
+        };
+
+        Instruction ins;
+        if (name == "offset") { expect(2); ins = { Op::Offset, 0, toFloat(args[1]), toFloat(args[2]) }; }
+        else if (name == "move") { expect(2); ins = { Op::Move, 0, toFloat(args[1]), toFloat(args[2]) }; }
+        else if (name == "dir") {
+            expect(1);
+            if (args[1] == "random") ins = { Op::Dir, 1, 0.f, 0.f };
+            else ins = { Op::Dir, 0, toFloat(args[1]), 0.f };
+        }
+        else if (name == "jitter") { expect(1); ins = { Op::Jitter, 0, toFloat(args[1]), 0.f }; }
+        else if (name == "base") { expect(1); ins = { Op::Base, 0, toFloat(args[1]), 0.f }; }
+        else if (name == "aim") { expect(0); ins = { Op::Aim, 0, 0.f, 0.f }; }
+        else if (name == "rotate") { expect(1); ins = { Op::Rotate, 0, toFloat(args[1]), 0.f }; }
+        else if (name == "fire") { expect(1); ins = { Op::Fire, 0, toFloat(args[1]), 0.f }; }
+        else if (name == "ring") { expect(1); ins = { Op::Ring, toCount(args[1]), 0.f, 0.f }; }
+        else if (name == "spread") { expect(3); ins = { Op::Spread, toCount(args[1]), toFloat(args[2]), toFloat(args[3]) }; }
+        else if (name == "wait") { expect(1); ins = { Op::Wait, 0, toFloat(args[1]), 0.f }; }
+        else if (name == "repeat") {
+            expect(1);
+            if (openLoops.size() == maxLoopDepth) throw std::invalid_argument("trop de repeat imbriques");
+            openLoops.push_back(program.m_code.size());
+            ins = { Op::Repeat, toCount(args[1]), 0.f, 0.f };
+        }
+        else if (name == "end") {
+            expect(0);
+            if (openLoops.empty()) throw std::invalid_argument("end sans repeat");
+            ins = { Op::End, static_cast<std::uint16_t>(openLoops.back() + 1), 0.f, 0.f };
+            openLoops.pop_back();
+        }
+        else if (name == "sound") { expect(1); ins = { Op::Sound, static_cast<std::uint16_t>(toEffect(args[1])), 0.f, 0.f }; }
+        else throw std::invalid_argument("instruction inconnue '" + name + "'");
+
+        program.m_code.push_back(ins);
+    }
+
+    if (!openLoops.empty()) throw std::invalid_argument("repeat sans end");
+    if (program.m_code.size() > 0xFFFF) throw std::invalid_argument("programme trop long");
+    return program;
+}
+
+const std::vector<BulletProgram::Instruction>& BulletProgram::getCode() const {
+    return m_code;
+}
+
+// ---------------- BulletEmitter ----------------
+void BulletEmitter::setTarget(const sf::Vector2f& target) {
+    s_target = target;
+}
+
+void BulletEmitter::start(std::shared_ptr<const BulletProgram> program, float restartDelay) {
+    m_program = std::move(program);
+    m_restartDelay = restartDelay;
+    m_wait = restartDelay;
+    m_rotation = 0.f;
+    restart();
+}
+
+// Back to the first instruction; the rotation carries over so spirals keep turning
+void BulletEmitter::restart() {
+    m_pc = 0;
+    m_loopDepth = 0;
+    m_offset = { 0.f, 0.f };
+    m_direction = 1;
+    m_randomDirection = false;
+    m_jitter = 0.f;
+    m_base = 0.f;
+}
+
+std::size_t BulletEmitter::update(const sf::Vector2f& origin, Pool& pool, CommandBuffer& commands, EventStream& events, float dt) {
+    if (!m_program) return 0;
+
+    m_wait -= dt;
+    if (m_wait > 0.f) return 0;
+    return run(origin, pool, commands, events);
+}
+
+// The caller's timer says the wait is over, m_wait was not counted down
+std::size_t BulletEmitter::fire(const sf::Vector2f& origin, Pool& pool, CommandBuffer& commands, EventStream& events) {
+    if (!m_program) return 0;
+
+    m_wait = 0.f;
+    return run(origin, pool, commands, events);
+}
+
+float BulletEmitter::getWait() const {
+    return m_program ? m_wait : -1.f;
+}
+
+// Executes instructions until the next wait
+std::size_t BulletEmitter::run(const sf::Vector2f& origin, Pool& pool, CommandBuffer& commands, EventStream& events) {
+    using Op = BulletProgram::Op;
+    const auto& code = m_program->getCode();
+
+    std::size_t requested = 0;
+    GameEvent shot{ .type = GameEvent::Type::Fire, .position = origin };
+    bool restarted = false;
+
+    // At most one restart per update, so a program without waits cannot spin
+    while (m_wait <= 0.f) {
+        if (m_pc >= code.size()) {
+            restart();
+            m_wait = m_restartDelay;
+            if (restarted) break;
+            restarted = true;
+            continue;
+        }
+
+        const auto& ins = code[m_pc++];
+        switch (ins.op) {
+        case Op::Offset:
+            m_offset = { ins.a, ins.b };
+            break;
+        case Op::Move:
+            m_offset += { ins.a, ins.b };
+            break;
+        case Op::Dir:
+            m_randomDirection = ins.count != 0;
+            m_direction = static_cast<int>(ins.a);
+            break;
+        case Op::Jitter:
+            m_jitter = ins.a;
+            break;
+        case Op::Base:
+            m_base = ins.a;
+            break;
+        case Op::Aim: {
+            const sf::Vector2f delta = s_target - (origin + m_offset);
+            m_base = std::atan2(delta.y, delta.x) * 180.f / 3.14159265f;
+            break;
+        }
+        case Op::Rotate:
+            m_rotation = std::fmod(m_rotation + ins.a, 360.f);
+            break;
+        case Op::Fire:
+            emit(pool, commands, origin, ins.a);
+            requested++;
+            break;
+        case Op::Ring:
+            for (std::uint16_t i = 0; i < ins.count; i++) {
+                emit(pool, commands, origin, 360.f * i / ins.count);
+            }
+            requested += ins.count;
+            break;
+        case Op::Spread:
+            if (ins.count == 1) {
+                emit(pool, commands, origin, ins.a);
+                requested++;
+                break;
+            }
+            for (std::uint16_t i = 0; i < ins.count; i++) {
+                emit(pool, commands, origin, ins.a - ins.b / 2.f + ins.b * i / (ins.count - 1));
+            }
+            requested += ins.count;
+            break;
+        case Op::Wait:
+            m_wait += ins.a;
+            break;
+        case Op::Repeat:
+            m_loopRemaining[m_loopDepth++] = ins.count;
+            break;
+        case Op::End:
+            if (--m_loopRemaining[m_loopDepth - 1] > 0) m_pc = ins.count;
+            else m_loopDepth--;
+            break;
+        case Op::Sound:
+            // a second sound in the same update gets its own event
+            if (shot.sound != SoundManager::Effect::Count) events.push(shot);
+            shot.sound = static_cast<SoundManager::Effect>(ins.count);
+            break;
+        }
+    }
+
+    shot.value = static_cast<int>(requested);
+    if (requested > 0 || shot.sound != SoundManager::Effect::Count) events.push(shot);
+    return requested;
+}
+
+void BulletEmitter::emit(Pool& pool, CommandBuffer& commands, const sf::Vector2f& origin, float angle) {
+    float finalAngle = m_base + m_rotation + angle;
+    if (m_jitter != 0.f) finalAngle += RandomGenerator::getFloat(-m_jitter, m_jitter);
+
+    int direction = m_direction;
+    if (m_randomDirection) direction = RandomGenerator::getInt(1, 2) == 2 ? -1 : 1;
+
+    PatternState state;
+    state.direction = direction;
+    state.angle = finalAngle;
+
+    commands.spawn(pool, origin + m_offset, state);
+}
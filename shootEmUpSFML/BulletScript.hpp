@@ -0,0 +1,110 @@
+#pragma once
+#include "MovementPatterns.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Pool;
+class CommandBuffer;
+class EventStream;
+
+// Bullet patterns written as a small script and compiled to bytecode, e.g.
+//   offset 60 88; repeat 3; ring 12; rotate 10; wait 0.2; end; sound swoosh
+//
+// Statements are separated by ';' or new lines:
+//   offset x y            emission point relative to the entity
+//   move dx dy            shifts the emission point
+//   dir -1|0|1|random     PatternState::direction of the next bullets
+//   jitter deg            random +-deg added to every angle
+//   base deg              angle the shots are relative to (0 = right, 90 = down)
+//   aim                   base = angle towards the emitter target
+//   rotate deg            adds to a rotation kept across restarts, for spirals
+//   fire deg              one bullet
+//   ring n                n bullets evenly spaced over 360 degrees
+//   spread n deg width    n bullets over width degrees centered on deg
+//   wait s                stops there for s seconds
+//   repeat n ... end      runs the block n times
+//   sound name            destruction, explosion, hit, rocket or swoosh
+//
+// When the program ends the emitter waits the entity's fire rate and starts over.
+class BulletProgram {
+public:
+    enum class Op : std::uint8_t {
+        Offset,
+        Move,
+        Dir,
+        Jitter,
+        Base,
+        Aim,
+        Rotate,
+        Fire,
+        Ring,
+        Spread,
+        Wait,
+        Repeat,
+        End,
+        Sound
+    };
+
+    // count: bullets for ring/spread, iterations for repeat, jump target for end,
+    // effect for sound, 1 for a random dir
+    struct Instruction {
+        Op op = Op::Fire;
+        std::uint16_t count = 0;
+        float a = 0.f;
+        float b = 0.f;
+    };
+
+    static constexpr std::size_t maxLoopDepth = 4;
+
+    // Throws std::invalid_argument on a syntax error
+    static BulletProgram compile(const std::string& source);
+
+    const std::vector<Instruction>& getCode() const;
+
+private:
+    std::vector<Instruction> m_code;
+};
+
+// Runs a BulletProgram for one entity. All state is fixed size; bullets are
+// requested through a CommandBuffer, which spawns them at the next sync point,
+// and shots and sounds are reported as one Fire event per update.
+class BulletEmitter {
+public:
+    // Starts from the beginning after restartDelay, nullptr stops the emitter
+    void start(std::shared_ptr<const BulletProgram> program, float restartDelay);
+
+    // Returns the number of bullets requested from pool
+    std::size_t update(const sf::Vector2f& origin, Pool& pool, CommandBuffer& commands, EventStream& events, float dt);
+    // Runs the program now, for callers that schedule it themselves from getWait()
+    std::size_t fire(const sf::Vector2f& origin, Pool& pool, CommandBuffer& commands, EventStream& events);
+    // Seconds until the program is due, negative without a program
+    float getWait() const;
+
+    // What `aim` points at, set once per frame
+    static void setTarget(const sf::Vector2f& target);
+
+private:
+    void restart();
+    std::size_t run(const sf::Vector2f& origin, Pool& pool, CommandBuffer& commands, EventStream& events);
+    void emit(Pool& pool, CommandBuffer& commands, const sf::Vector2f& origin, float angle);
+
+    std::shared_ptr<const BulletProgram> m_program;
+    float m_restartDelay = 0.f;
+    float m_wait = 0.f;
+    std::size_t m_pc = 0;
+    std::array<int, BulletProgram::maxLoopDepth> m_loopRemaining{};
+    std::size_t m_loopDepth = 0;
+
+    sf::Vector2f m_offset{ 0.f, 0.f };
+    int m_direction = 1;
+    bool m_randomDirection = false;
+    float m_jitter = 0.f;
+    float m_base = 0.f;
+    float m_rotation = 0.f;
+
+    inline static sf::Vector2f s_target{ 0.f, 0.f };
+};
@@ -1,75 +1,72 @@
 #include "ColisionManager.hpp"
-#include "SoundManager.hpp"
-#include "ScoreManager.hpp"
 
-void ColisionManager::update() {
+ColisionManager::ColisionManager(PoolManager& pools)
+    : m_pools(&pools)
+{
+}
 
-    std::vector<Pool*> enemyPools = {
-        &pools.fighter,
-        &pools.scout,
-        &pools.frigate,
-        &pools.torpedo,
-        &pools.bomber,
-        &pools.battleCruiser
-    };
+void ColisionManager::update(CommandBuffer& commands, EventStream& events) {
+    PoolManager& pools = *m_pools;
 
-    std::vector<std::shared_ptr<Pool>*> enemybulletPools = {
-        &pools.fighterBullet,
-        &pools.scoutBullet,
-        &pools.frigateBullet,
-        &pools.torpedoBullet,
-        &pools.bomberBullet,
-        &pools.battleCruiserBullet
-    };
+    if (pools.playerBullet->getActiveCount() > 0) {
+        for (auto& type : pools.enemies) {
+            if (type.ship->getActiveCount() == 0) continue;
+            type.ship->forEachActive([&](Entity enemy) {
+                pools.playerBullet->forEachActive([&](Entity proj) {
+                    // a ship killed earlier this frame is still active until the commands are applied
+                    if (enemy.getHealth() <= 0 || !enemy.hurtBy(proj)) return;
 
-    for (auto pool : enemyPools) {
-        for (auto& enemy : pool->getPool()) {
-            if (!enemy->isActive()) continue;
-            for (auto& proj : pools.playerBullet.getPool()) {
-                if (proj->isActive() && enemy->hurtBy(*proj)) {
-                    proj->deactivate();
-                    enemy->takeDamage(proj->getDamage());
-                    if (enemy->getHealth() <= 0) {
-                        enemy->deactivate();
+                    proj.deactivate();
+                    enemy.takeDamage(proj.getDamage());
+                    if (enemy.getHealth() <= 0) {
+                        commands.despawn(enemy);
 
-                        auto destructionPool = enemy->getDestructionPool();
-                        auto entity = destructionPool->spawn(enemy->getPosition());
-                        entity->getComposite().stopAnimationAfterLoop(0, true);
-                        SoundManager::playDestruction();
-                        ScoreManager::addScore(enemy->getScore());
-                        continue;
+                        // destruction= is optional in the config
+                        events.push({
+                            .type = GameEvent::Type::Kill,
+                            .position = enemy.getPosition(),
+                            .value = enemy.getScore(),
+                            .effectPool = enemy.getDestructionPool()
+                        });
+                        return;
                     }
-                    SoundManager::playHit();
-                }
-            }
+
+                    events.push({
+                        .type = GameEvent::Type::Hit,
+                        .position = enemy.getPosition(),
+                        .value = proj.getDamage(),
+                        .health = enemy.getHealth()
+                    });
+                });
+            });
         }
     }
 
-    for (auto& player : pools.player.getPool()) {
-        if (player->isActive()) {
-            for (auto pool : enemybulletPools) {
-                for (auto& proj : (*pool)->getPool()) {
-                    if (proj->isActive() && player->hurtBy(*proj)) {
-                        proj->deactivate();
-                        player->takeDamage(proj->getDamage());
-                        changePlayerSprite(player);
-                        if (player->getHealth() <= 0) {
-                            player->deactivate();
-                            // TODO game over screen
-                            SoundManager::playDestruction();
-                            continue;
-                        }
-                        SoundManager::playHit();
-                    }
-                }
-            }
+    pools.player->forEachActive([&](Entity player) {
+        for (auto& type : pools.enemies) {
+            if (!type.bullet || type.bullet->getActiveCount() == 0) continue;
+            type.bullet->forEachActive([&](Entity proj) {
+                if (player.getHealth() <= 0 || !player.hurtBy(proj)) return;
+
+                proj.deactivate();
+                player.takeDamage(proj.getDamage());
+                changePlayerSprite(player);
+                if (player.getHealth() <= 0) commands.despawn(player);
+
+                events.push({
+                    .type = GameEvent::Type::PlayerDamaged,
+                    .position = player.getPosition(),
+                    .value = proj.getDamage(),
+                    .health = player.getHealth()
+                });
+            });
         }
-    }
+    });
 }
 
-void ColisionManager::changePlayerSprite(std::shared_ptr<Entity> player) {
-    auto& comp = player->getComposite();
-    float healthPercent = player->getHealthPercent();
+void ColisionManager::changePlayerSprite(Entity player) {
+    auto& comp = player.getComposite();
+    float healthPercent = player.getHealthPercent();
     if (healthPercent <= 0.25f)
     {
         comp.setVisible(6, false);
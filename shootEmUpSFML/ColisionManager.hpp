@@ -4,12 +4,19 @@
 #include <iostream>
 #include "Pool.hpp"
 #include "SpriteComposite.hpp"
+#include "CommandBuffer.hpp"
+#include "EventStream.hpp"
 
 class ColisionManager {
 public:
-    PoolManager pools;
+    ColisionManager(PoolManager& pools);
 
-    void update();
+    // Bullets are consumed on the spot so one bullet cannot hit twice; kills are
+    // recorded into `commands`, and hits and kills into `events`
+    void update(CommandBuffer& commands, EventStream& events);
 
-    void changePlayerSprite(std::shared_ptr<Entity> player);
+    void changePlayerSprite(Entity player);
+
+private:
+    PoolManager* m_pools;
 };
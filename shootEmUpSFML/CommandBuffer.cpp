@@ -0,0 +1,47 @@
+#include "CommandBuffer.hpp"
+#include "Pool.hpp"
+#include <algorithm>
+#include <functional>
+
+void CommandBuffer::spawn(Pool& pool, const sf::Vector2f& position) {
+    m_spawns.push_back({ &pool, position, pool.getPatternState() });
+}
+
+void CommandBuffer::spawn(Pool& pool, const sf::Vector2f& position, const PatternState& state) {
+    m_spawns.push_back({ &pool, position, state });
+}
+
+void CommandBuffer::despawn(Entity entity) {
+    m_despawns.push_back(entity);
+}
+
+std::size_t CommandBuffer::apply() {
+    for (Entity& entity : m_despawns) entity.deactivate();
+    m_despawns.clear();
+
+    std::stable_sort(m_spawns.begin(), m_spawns.end(), [](const Spawn& a, const Spawn& b) {
+        return std::less<Pool*>()(a.pool, b.pool);
+    });
+
+    std::size_t spawned = 0;
+    for (std::size_t first = 0; first < m_spawns.size(); ) {
+        Pool* pool = m_spawns[first].pool;
+        m_positions.clear();
+        m_states.clear();
+
+        std::size_t last = first;
+        for (; last < m_spawns.size() && m_spawns[last].pool == pool; last++) {
+            m_positions.push_back(m_spawns[last].position);
+            m_states.push_back(m_spawns[last].state);
+        }
+
+        spawned += pool->spawnBatch(m_positions.data(), m_states.data(), m_positions.size());
+        first = last;
+    }
+    m_spawns.clear();
+    return spawned;
+}
+
+std::size_t CommandBuffer::getPendingCount() const {
+    return m_spawns.size() + m_despawns.size();
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Entity.hpp"
+#include "MovementPatterns.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+class Pool;
+
+// Spawns and despawns requested while pools are being iterated, applied together
+// at the frame's sync points instead of changing a pool under someone's loop.
+// Each thread that updates entities records into its own buffer and the buffers
+// are applied one after the other; the game updates on one thread, so main owns one.
+class CommandBuffer {
+public:
+    // Without a state the pool's own pattern state is used, as with Pool::spawn
+    void spawn(Pool& pool, const sf::Vector2f& position);
+    void spawn(Pool& pool, const sf::Vector2f& position, const PatternState& state);
+    void despawn(Entity entity);
+
+    // Despawns first so their slots can be reused, then the spawns grouped by pool,
+    // in request order, with one spawnBatch per pool. Returns the number spawned.
+    std::size_t apply();
+
+    std::size_t getPendingCount() const;
+
+private:
+    struct Spawn {
+        Pool* pool;
+        sf::Vector2f position;
+        PatternState state;
+    };
+
+    std::vector<Spawn> m_spawns;
+    std::vector<Entity> m_despawns;
+
+    // One pool's batch, kept to avoid allocating on every apply
+    std::vector<sf::Vector2f> m_positions;
+    std::vector<PatternState> m_states;
+};
@@ -0,0 +1,81 @@
+#include "Director.hpp"
+#include "randomGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+
+Director::Director(PoolManager& pools, const EntityConfig& config)
+    : m_pools(&pools),
+    m_settings(config.director)
+{
+    for (const auto& wave : config.waves) {
+        for (int i = 0; i < wave.count; i++) {
+            m_schedule.push_back({ wave.time + wave.interval * i, wave.enemy });
+        }
+    }
+    std::stable_sort(m_schedule.begin(), m_schedule.end(), [](const Spawn& a, const Spawn& b) { return a.time < b.time; });
+
+    m_length = m_settings.loopLength;
+    if (!m_schedule.empty()) m_length = std::max(m_length, m_schedule.back().time);
+}
+
+void Director::reset() {
+    m_cursor = 0;
+    m_time = 0.f;
+    m_timeScale = 1.f;
+    m_loop = 0;
+    m_frameMs = 0.f;
+    m_throttled = false;
+}
+
+void Director::update(float dt, float frameMs) {
+    m_frameMs += (frameMs - m_frameMs) * 0.1f;
+    measureLoad();
+
+    m_throttled = m_shipLoad >= m_settings.maxShipLoad
+        || m_enemyBullets >= m_settings.maxEnemyBullets
+        || m_frameMs > m_settings.frameBudgetMs;
+    if (m_throttled || m_schedule.empty()) return;
+
+    m_time += dt / m_timeScale;
+
+    int spawned = 0;
+    while (spawned < m_settings.maxSpawnsPerFrame && m_cursor < m_schedule.size() && m_schedule[m_cursor].time <= m_time) {
+        const float x = RandomGenerator::getFloat(50.f, 1230.f);
+        m_pools->enemies[m_schedule[m_cursor].enemy].ship->spawn({ x, -50.f });
+        m_cursor++;
+        spawned++;
+    }
+
+    // Each pass over the timeline plays faster
+    if (m_cursor == m_schedule.size() && m_time >= m_length) {
+        m_time -= m_length;
+        m_cursor = 0;
+        m_loop++;
+        m_timeScale = std::max(m_settings.minTimeScale, std::pow(1.f / m_settings.loopSpeedup, static_cast<float>(m_loop)));
+    }
+}
+
+void Director::measureLoad() {
+    m_shipLoad = 0;
+    m_enemyBullets = 0;
+    for (const auto& type : m_pools->enemies) {
+        m_shipLoad += static_cast<int>(type.ship->getActiveCount()) * type.cost;
+        if (type.bullet) m_enemyBullets += type.bullet->getActiveCount();
+    }
+}
+
+bool Director::isThrottled() const {
+    return m_throttled;
+}
+
+int Director::getShipLoad() const {
+    return m_shipLoad;
+}
+
+std::size_t Director::getEnemyBullets() const {
+    return m_enemyBullets;
+}
+
+int Director::getLoop() const {
+    return m_loop;
+}
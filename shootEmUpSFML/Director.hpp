@@ -0,0 +1,47 @@
+#pragma once
+#include "Pool.hpp"
+#include "EntityConfig.hpp"
+#include <vector>
+
+// Spawns enemies from the wave timeline of entities.cfg. The waves are flattened
+// into one entry per ship, sorted by time, and walked with a cursor. While the
+// ships alive, the enemy bullets or the frame time are over budget the timeline
+// is paused, so waves arrive late instead of piling more load on.
+class Director {
+public:
+    Director(PoolManager& pools, const EntityConfig& config);
+
+    // Back to the start of the timeline at normal speed
+    void reset();
+
+    // frameMs is the update + draw time of the previous frame
+    void update(float dt, float frameMs);
+
+    bool isThrottled() const;
+    int getShipLoad() const;
+    std::size_t getEnemyBullets() const;
+    int getLoop() const;
+
+private:
+    struct Spawn {
+        float time = 0.f;
+        std::size_t enemy = 0;
+    };
+
+    void measureLoad();
+
+    PoolManager* m_pools;
+    EntityConfig::DirectorDef m_settings;
+    std::vector<Spawn> m_schedule;
+    float m_length = 0.f;
+
+    std::size_t m_cursor = 0;
+    float m_time = 0.f;
+    float m_timeScale = 1.f;
+    int m_loop = 0;
+
+    float m_frameMs = 0.f;
+    int m_shipLoad = 0;
+    std::size_t m_enemyBullets = 0;
+    bool m_throttled = false;
+};
@@ -1,36 +0,0 @@
-#pragma once
-#include "Pool.hpp"   
-#include <vector>
-#include <memory>
-#include <random>
-
-struct EnemyType {
-    int cost;            
-    std::function<void(sf::Vector2f)> spawnFunc;
-};
-
-class EnemySpawner {
-public:
-    EnemySpawner(PoolManager& pools);
-
-    void update(float dt);
-
-    void addEnemyType(int cost, std::function<void(sf::Vector2f)> spawnFunc);
-
-    void setPointGainInterval(float seconds);
-
-private:
-    PoolManager* m_pools;
-
-    std::vector<EnemyType> m_enemyTypes;
-
-    int m_points = 20;
-    float m_pointGainTimer = 0.f;
-    float m_pointGainInterval = 12.f; 
-    int m_pointGainAmount = 30;    
-    float m_pointMultiplier = 1.4f; 
-
-    std::mt19937 m_rng;
-
-    void trySpawnEnemy();
-};
@@ -1,98 +1,63 @@
 #pragma once
-#include <functional>
-#include <vector>
-#include <memory>
-#include "SpriteComposite.hpp"
+#include <cstdint>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
 #include "MovementPatterns.hpp"
 
 class Pool;
+class SpriteComposite;
 
-class Entity : public sf::Drawable {
+// Handle to one slot of a pool, cheap to copy. The data lives in the pool: the hot
+// record in a vector walked by the update and collision loops, the sprite in another.
+class Entity {
 public:
-    using BulletSpawner = std::function<void(Entity&, Pool&, float)>;
-
-    enum class Type {
+    enum class Type : std::uint8_t {
         Player,
         Enemy
     };
 
-    explicit Entity(Type type);
-    virtual ~Entity();
-
-    void setComposite(SpriteComposite composite);
-    void setHitbox(const sf::Vector2f& size, const sf::Vector2f& offset = { 0.f, 0.f });
-    void setHurtbox(const sf::Vector2f& size, const sf::Vector2f& offset = { 0.f, 0.f });
-
-    void setMovementPattern(MovementPattern pattern);
-    void setPatternState(PatternState pattern);
-    void setDestructionPool(std::shared_ptr<Pool> pool);
-    std::shared_ptr<Pool> getDestructionPool();
-
-    void setBulletSpawner(BulletSpawner bulletSpawner);
-    void setFireRate(float fr);
-    void setBulletPool(std::shared_ptr<Pool> pool);
+    // What the pool update and collision loops read for every entity each frame, stored
+    // by slot. Boxes, damage and the movement pattern are pool settings.
+    struct Hot {
+        sf::Vector2f position{ 0.f, 0.f };
+        PatternState patternState;
+        int health = 1;
+    };
 
-    void update(float dt);
+    Entity(Pool& pool, std::uint32_t slot);
 
     void move(const sf::Vector2f& offset);
     void setPosition(const sf::Vector2f& pos);
     sf::Vector2f getPosition() const;
 
-    void setDesactivateAfterAnimation(bool desactivateAfterAnimation);
-
-    const sf::FloatRect& getHitbox() const;
-    const sf::FloatRect& getHurtbox() const;
+    sf::FloatRect getHitbox() const;
+    sf::FloatRect getHurtbox() const;
 
-    SpriteComposite& getComposite();
+    // Its position is synced from the hot record when the pool draws it
+    SpriteComposite& getComposite() const;
     Type getType() const;
+    std::uint32_t getSlot() const;
 
     int getHealth() const;
     int getInitHealth() const;
     float getHealthPercent() const;
-    void setHealth(int hp);
     void takeDamage(int dmg);
-    void setDamage(int dmg);
-    int getDamage();
+    int getDamage() const;
 
-    void setScore(int score);
-    int getScore();
+    // Pool settings, the same for all its entities
+    int getScore() const;
+    Pool* getDestructionPool() const;
 
     bool hurtBy(const Entity& proj) const;
 
-    bool isActive();
+    bool isActive() const;
     void activate();
     void deactivate();
 
 private:
-    std::shared_ptr<Pool> bulletPool;
-    std::shared_ptr<Pool> destrcutionPool;
-    SpriteComposite m_composite;
-
-    sf::FloatRect m_hitbox{};
-    sf::Vector2f m_hitboxOffset{ 0.f, 0.f };
-
-    sf::FloatRect m_hurtbox{};
-    sf::Vector2f m_hurtboxOffset{ 0.f, 0.f };
-
-    sf::Vector2f velocity;
-    MovementPattern m_pattern;
-    PatternState m_patternState;
-    BulletSpawner m_bulletSpawner;
-
-    float lastFire = 0.f;
-    float m_fireRate = 0.f;
-
-    Type m_type;
-    int m_health = 1;
-    int m_initHealth = 1;
-    int m_damage = 0;
-    bool actived = false;
-    bool m_desactivateAfterAnimation = false;
-
-    int score = 0;
-
-    inline static std::vector<Entity*> s_players{};
-    inline static std::vector<Entity*> s_enemies{};
+    Hot& hot() const;
 
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    Pool* m_pool;
+    std::uint32_t m_slot;
 };
+static_assert(sizeof(Entity::Hot) <= 64, "the hot part of an entity must fit in a cache line");
@@ -0,0 +1,288 @@
+#include "EntityConfig.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    struct Field {
+        std::string key;
+        std::string value;
+        bool flag = false;
+    };
+
+    // Splits on whitespace, keeping "quoted values" whole and dropping # comments
+    std::vector<std::string> tokenize(const std::string& line) {
+        std::vector<std::string> tokens;
+        std::string current;
+        bool quoted = false;
+        bool hasToken = false;
+
+        for (char c : line) {
+            if (c == '"') {
+                quoted = !quoted;
+                hasToken = true;
+            } else if (!quoted && c == '#') {
+                break;
+            } else if (!quoted && (c == ' ' || c == '\t' || c == '\r')) {
+                if (hasToken) tokens.push_back(current);
+                current.clear();
+                hasToken = false;
+            } else {
+                current += c;
+                hasToken = true;
+            }
+        }
+        if (quoted) throw std::invalid_argument("guillemet non ferme");
+        if (hasToken) tokens.push_back(current);
+        return tokens;
+    }
+
+    std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator)) parts.push_back(part);
+        return parts;
+    }
+
+    float toFloat(const std::string& text) {
+        std::size_t used = 0;
+        float value = std::stof(text, &used);
+        if (used != text.size()) throw std::invalid_argument("nombre invalide '" + text + "'");
+        return value;
+    }
+
+    int toInt(const std::string& text) {
+        std::size_t used = 0;
+        int value = std::stoi(text, &used);
+        if (used != text.size()) throw std::invalid_argument("entier invalide '" + text + "'");
+        return value;
+    }
+
+    // Sizes and counts: a negative value would wrap around once cast
+    std::size_t toSize(const std::string& key, const std::string& text) {
+        const int value = toInt(text);
+        if (value <= 0) throw std::invalid_argument(key + " doit etre > 0, pas '" + text + "'");
+        return static_cast<std::size_t>(value);
+    }
+
+    sf::Vector2f toVector2f(const std::string& text) {
+        auto parts = split(text, ',');
+        if (parts.size() != 2) throw std::invalid_argument("vecteur invalide '" + text + "'");
+        return { toFloat(parts[0]), toFloat(parts[1]) };
+    }
+
+    // name(a,b,c) -> name + { a, b, c }
+    void toPattern(const std::string& text, std::string& name, std::vector<float>& params) {
+        const auto open = text.find('(');
+        if (open == std::string::npos || text.back() != ')') throw std::invalid_argument("pattern invalide '" + text + "'");
+
+        name = text.substr(0, open);
+        params.clear();
+        const std::string args = text.substr(open + 1, text.size() - open - 2);
+        if (args.empty()) return;
+        for (const auto& arg : split(args, ',')) params.push_back(toFloat(arg));
+    }
+}
+
+EntityConfig::EntityConfig(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Impossible de charger " + path.string());
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        try {
+            auto tokens = tokenize(line);
+            if (tokens.empty()) continue;
+            const std::string& kind = tokens[0];
+            // the director line is the only one without a name
+            const std::size_t firstField = kind == "director" ? 1 : 2;
+            if (tokens.size() < firstField) throw std::invalid_argument("nom manquant");
+            const std::string name = firstField == 2 ? tokens[1] : "";
+
+            std::vector<Field> fields;
+            for (std::size_t i = firstField; i < tokens.size(); i++) {
+                const auto equal = tokens[i].find('=');
+                if (equal == std::string::npos) fields.push_back({ tokens[i], "", true });
+                else fields.push_back({ tokens[i].substr(0, equal), tokens[i].substr(equal + 1), false });
+            }
+
+            if (kind == "sheet") {
+                Sheet sheet;
+                sheet.name = name;
+                bool hasStride = false;
+                for (const auto& field : fields) {
+                    if (field.key == "path") sheet.path = field.value;
+                    else if (field.key == "cell") sheet.strip.cellSize = sf::Vector2i(toVector2f(field.value));
+                    else if (field.key == "origin") sheet.strip.origin = sf::Vector2i(toVector2f(field.value));
+                    else if (field.key == "stride") {
+                        sheet.strip.stride = sf::Vector2i(toVector2f(field.value));
+                        hasStride = true;
+                    }
+                    else if (field.key == "frames") sheet.strip.count = toInt(field.value);
+                    else if (field.key == "delay") sheet.delay = toFloat(field.value);
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                if (sheet.path.empty()) throw std::invalid_argument("path manquant");
+                if (sheet.strip.count > 0 && (sheet.strip.cellSize.x <= 0 || sheet.strip.cellSize.y <= 0)) {
+                    throw std::invalid_argument("cell manquant pour une animation");
+                }
+                if (!hasStride) sheet.strip.stride = { sheet.strip.cellSize.x, 0 };
+                sheets.push_back(sheet);
+            }
+            else if (kind == "sprite") {
+                Sprite sprite;
+                sprite.name = name;
+                sprite.firstChild = children.size();
+                for (const auto& field : fields) {
+                    if (field.flag && field.key == "flipX") sprite.flipX = true;
+                    else if (field.flag && field.key == "flipY") sprite.flipY = true;
+                    else if (field.flag && field.key == "bake") sprite.bake = true;
+                    else if (field.key == "children") {
+                        for (const auto& entry : split(field.value, ',')) {
+                            auto parts = split(entry, ':');
+                            SpriteChild child;
+                            child.sheet = findSheet(parts[0]);
+                            for (std::size_t i = 1; i < parts.size(); i++) {
+                                if (parts[i] == "hidden") child.visible = false;
+                                else if (parts[i] == "paused") child.animationActive = false;
+                                else throw std::invalid_argument("option inconnue '" + parts[i] + "'");
+                            }
+                            children.push_back(child);
+                        }
+                    }
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                sprite.childCount = children.size() - sprite.firstChild;
+                if (sprite.childCount == 0) throw std::invalid_argument("sprite sans children");
+                sprites.push_back(sprite);
+            }
+            else if (kind == "script") {
+                Script script;
+                script.name = name;
+                for (const auto& field : fields) {
+                    if (field.key == "code") script.program = std::make_shared<const BulletProgram>(BulletProgram::compile(field.value));
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                if (!script.program) throw std::invalid_argument("code manquant");
+                scripts.push_back(script);
+            }
+            else if (kind == "pool") {
+                PoolDef pool;
+                pool.name = name;
+                bool hasSprite = false;
+                for (const auto& field : fields) {
+                    if (field.flag && field.key == "despawnAfterAnimation") pool.despawnAfterAnimation = true;
+                    else if (field.key == "type") {
+                        if (field.value == "player") pool.type = Entity::Type::Player;
+                        else if (field.value == "enemy") pool.type = Entity::Type::Enemy;
+                        else throw std::invalid_argument("type inconnu '" + field.value + "'");
+                    }
+                    else if (field.key == "capacity") pool.capacity = toSize(field.key, field.value);
+                    else if (field.key == "grow") pool.growChunk = toSize(field.key, field.value);
+                    else if (field.key == "maxCapacity") pool.maxCapacity = toSize(field.key, field.value);
+                    else if (field.key == "sprite") { pool.sprite = findSprite(field.value); hasSprite = true; }
+                    else if (field.key == "pattern") toPattern(field.value, pool.pattern, pool.patternParams);
+                    else if (field.key == "emitter") pool.emitter = findScript(field.value);
+                    else if (field.key == "hitbox") pool.hitbox = toVector2f(field.value);
+                    else if (field.key == "hurtbox") pool.hurtbox = toVector2f(field.value);
+                    else if (field.key == "offset") pool.offset = toVector2f(field.value);
+                    else if (field.key == "health") pool.health = toInt(field.value);
+                    else if (field.key == "damage") pool.damage = toInt(field.value);
+                    else if (field.key == "fireRate") pool.fireRate = toFloat(field.value);
+                    else if (field.key == "bullets") pool.bullets = findPool(field.value);
+                    else if (field.key == "destruction") pool.destruction = findPool(field.value);
+                    else if (field.key == "score") pool.score = toInt(field.value);
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                if (!hasSprite) throw std::invalid_argument("sprite manquant");
+                if (pool.bullets == npos && pool.emitter != npos) throw std::invalid_argument("emitter sans bullets");
+                // effect pools only animate, see PoolOf
+                if (pool.despawnAfterAnimation && (!pool.pattern.empty() || pool.emitter != npos)) {
+                    throw std::invalid_argument("despawnAfterAnimation exige un pool sans pattern ni emitter");
+                }
+                pools.push_back(pool);
+            }
+            else if (kind == "enemy") {
+                Enemy enemy;
+                enemy.pool = findPool(name);
+                for (const auto& field : fields) {
+                    if (field.key == "cost") enemy.cost = toInt(field.value);
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                if (enemy.cost <= 0) throw std::invalid_argument("cost manquant");
+                enemies.push_back(enemy);
+            }
+            else if (kind == "wave") {
+                Wave wave;
+                wave.enemy = findEnemy(name);
+                for (const auto& field : fields) {
+                    if (field.key == "at") wave.time = toFloat(field.value);
+                    else if (field.key == "count") wave.count = toInt(field.value);
+                    else if (field.key == "interval") wave.interval = toFloat(field.value);
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                if (wave.count <= 0) throw std::invalid_argument("count invalide");
+                waves.push_back(wave);
+            }
+            else if (kind == "director") {
+                for (const auto& field : fields) {
+                    if (field.key == "loop") director.loopLength = toFloat(field.value);
+                    else if (field.key == "loopSpeedup") director.loopSpeedup = toFloat(field.value);
+                    else if (field.key == "minTimeScale") director.minTimeScale = toFloat(field.value);
+                    else if (field.key == "maxShipLoad") director.maxShipLoad = toInt(field.value);
+                    else if (field.key == "maxEnemyBullets") director.maxEnemyBullets = toSize(field.key, field.value);
+                    else if (field.key == "frameBudget") director.frameBudgetMs = toFloat(field.value);
+                    else if (field.key == "maxSpawnsPerFrame") director.maxSpawnsPerFrame = toInt(field.value);
+                    else throw std::invalid_argument("cle inconnue '" + field.key + "'");
+                }
+                if (director.loopSpeedup < 1.f) throw std::invalid_argument("loopSpeedup doit etre >= 1");
+            }
+            else {
+                throw std::invalid_argument("type de ligne inconnu '" + kind + "'");
+            }
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error(path.string() + ":" + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+}
+
+std::size_t EntityConfig::findSheet(const std::string& name) const {
+    for (std::size_t i = 0; i < sheets.size(); i++) {
+        if (sheets[i].name == name) return i;
+    }
+    throw std::invalid_argument("sheet inconnue '" + name + "'");
+}
+
+std::size_t EntityConfig::findScript(const std::string& name) const {
+    for (std::size_t i = 0; i < scripts.size(); i++) {
+        if (scripts[i].name == name) return i;
+    }
+    throw std::invalid_argument("script inconnu '" + name + "'");
+}
+
+std::size_t EntityConfig::findEnemy(const std::string& name) const {
+    for (std::size_t i = 0; i < enemies.size(); i++) {
+        if (pools[enemies[i].pool].name == name) return i;
+    }
+    throw std::invalid_argument("enemy inconnu '" + name + "'");
+}
+
+std::size_t EntityConfig::findSprite(const std::string& name) const {
+    for (std::size_t i = 0; i < sprites.size(); i++) {
+        if (sprites[i].name == name) return i;
+    }
+    throw std::invalid_argument("sprite inconnu '" + name + "'");
+}
+
+std::size_t EntityConfig::findPool(const std::string& name) const {
+    for (std::size_t i = 0; i < pools.size(); i++) {
+        if (pools[i].name == name) return i;
+    }
+    throw std::invalid_argument("pool inconnu '" + name + "'");
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "Entity.hpp"
+#include "BulletScript.hpp"
+#include "SpriteComposite.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Sheets, sprites, bullet scripts, pools, enemies and the wave timeline read from assets/config/entities.cfg.
+// Everything is resolved to indices into these flat tables while parsing, so
+// building the pools never looks anything up by name.
+class EntityConfig {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Animation strip, or a static image when strip.count is 0
+    struct Sheet {
+        std::string name;
+        std::string path;
+        Strip strip;
+        float delay = 0.f;
+    };
+
+    struct SpriteChild {
+        std::size_t sheet = 0;
+        bool visible = true;
+        bool animationActive = true;
+    };
+
+    // Children are children[firstChild, firstChild + childCount)
+    struct Sprite {
+        std::string name;
+        std::size_t firstChild = 0;
+        std::size_t childCount = 0;
+        bool flipX = false;
+        bool flipY = false;
+        bool bake = false;
+    };
+
+    struct Script {
+        std::string name;
+        std::shared_ptr<const BulletProgram> program;
+    };
+
+    struct PoolDef {
+        std::string name;
+        Entity::Type type = Entity::Type::Enemy;
+        std::size_t capacity = 32;
+        std::size_t growChunk = 0;
+        std::size_t maxCapacity = 0;
+        std::size_t sprite = 0;
+        std::string pattern;
+        std::vector<float> patternParams;
+        std::size_t emitter = npos;
+        sf::Vector2f hitbox = { 0.f, 0.f };
+        sf::Vector2f hurtbox = { 0.f, 0.f };
+        sf::Vector2f offset = { 0.f, 0.f };
+        int health = 1;
+        int damage = 0;
+        float fireRate = 0.f;
+        std::size_t bullets = npos;
+        std::size_t destruction = npos;
+        bool despawnAfterAnimation = false;
+        int score = 0;
+    };
+
+    struct Enemy {
+        std::size_t pool = 0;
+        int cost = 0;
+    };
+
+    // count ships of enemies[enemy], one every interval seconds starting at time
+    struct Wave {
+        float time = 0.f;
+        std::size_t enemy = 0;
+        int count = 1;
+        float interval = 0.f;
+    };
+
+    // Pacing and budgets of the Director
+    struct DirectorDef {
+        float loopLength = 0.f;           // the timeline restarts after this, 0 = right after the last spawn
+        float loopSpeedup = 1.f;          // each loop plays this much faster...
+        float minTimeScale = 0.25f;       // ...down to this fraction of the authored timings
+        int maxShipLoad = 200;            // summed cost of the ships alive
+        std::size_t maxEnemyBullets = 1500;
+        float frameBudgetMs = 12.f;       // average update + draw time above which spawns are held back
+        int maxSpawnsPerFrame = 1;
+    };
+
+    // Throws std::runtime_error with the file and line on any error
+    explicit EntityConfig(const std::filesystem::path& path);
+
+    std::size_t findSprite(const std::string& name) const;
+    std::size_t findPool(const std::string& name) const;
+
+    std::vector<Sheet> sheets;
+    std::vector<SpriteChild> children;
+    std::vector<Sprite> sprites;
+    std::vector<Script> scripts;
+    std::vector<PoolDef> pools;
+    std::vector<Enemy> enemies;
+    std::vector<Wave> waves;
+    DirectorDef director;
+
+private:
+    std::size_t findSheet(const std::string& name) const;
+    std::size_t findScript(const std::string& name) const;
+    std::size_t findEnemy(const std::string& name) const;
+};
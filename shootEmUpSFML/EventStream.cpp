@@ -0,0 +1,48 @@
+#include "EventStream.hpp"
+
+EventStream::EventStream() : m_events(initialCapacity) {
+}
+
+void EventStream::push(const GameEvent& event) {
+    if (m_head - m_tail == m_events.size()) grow();
+    m_events[m_head & (m_events.size() - 1)] = event;
+    m_head++;
+}
+
+// Doubles the ring, oldest event first, so the indices stay masks of a power of two
+void EventStream::grow() {
+    std::vector<GameEvent> events(m_events.size() * 2);
+    std::size_t count = 0;
+    forEach([&](const GameEvent& event) { events[count++] = event; });
+    m_events = std::move(events);
+    m_tail = 0;
+    m_head = count;
+}
+
+void EventStream::clear() {
+    m_tail = m_head;
+}
+
+std::size_t EventStream::size() const {
+    return m_head - m_tail;
+}
+
+std::size_t EventStream::getCapacity() const {
+    return m_events.size();
+}
+
+void EventStats::consume(const EventStream& events) {
+    events.forEach([&](const GameEvent& event) {
+        m_counts[static_cast<std::size_t>(event.type)]++;
+        if (event.type == GameEvent::Type::Fire) m_bullets += static_cast<std::size_t>(event.value);
+    });
+}
+
+void EventStats::print(std::ostream& out, const EventStream& events) const {
+    out << "Evenements: " << m_counts[static_cast<std::size_t>(GameEvent::Type::Fire)] << " tirs ("
+        << m_bullets << " balles), "
+        << m_counts[static_cast<std::size_t>(GameEvent::Type::Hit)] << " touches, "
+        << m_counts[static_cast<std::size_t>(GameEvent::Type::Kill)] << " destructions, "
+        << m_counts[static_cast<std::size_t>(GameEvent::Type::PlayerDamaged)] << " degats joueur, "
+        << "file de " << events.getCapacity() << " evenements\n";
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "SoundManager.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+class Pool;
+
+// What gameplay tells the rest of the game. Plain data, so writing one is a copy.
+struct GameEvent {
+    enum class Type : std::uint8_t {
+        Hit,
+        Kill,
+        Fire,
+        PlayerDamaged
+    };
+
+    Type type = Type::Hit;
+    // Fire: the sound the script asked for, Count for none
+    SoundManager::Effect sound = SoundManager::Effect::Count;
+    sf::Vector2f position;
+    // Hit, PlayerDamaged: damage taken. Kill: score. Fire: bullets requested.
+    int value = 0;
+    // Hit, PlayerDamaged: health left
+    int health = 0;
+    // Kill: where the destruction effect spawns, may be null
+    Pool* effectPool = nullptr;
+};
+static_assert(std::is_trivially_copyable_v<GameEvent>, "GameEvent is copied into the ring as is");
+
+// Ring of events written by the gameplay systems during the frame and read once,
+// in one batch, by every consumer. A full ring doubles, so no event is ever lost:
+// kills carry the score and the destruction effect.
+class EventStream {
+public:
+    static constexpr std::size_t initialCapacity = 4096;
+
+    EventStream();
+
+    void push(const GameEvent& event);
+
+    // Calls f(event) for every event since the last clear, oldest first
+    template<class F>
+    void forEach(F&& f) const {
+        const std::size_t mask = m_events.size() - 1;
+        for (std::size_t i = m_tail; i != m_head; i++) f(m_events[i & mask]);
+    }
+
+    // Once every consumer has read the batch
+    void clear();
+
+    std::size_t size() const;
+    std::size_t getCapacity() const;
+
+private:
+    static_assert((initialCapacity & (initialCapacity - 1)) == 0, "capacity must be a power of two");
+
+    void grow();
+
+    std::vector<GameEvent> m_events;
+    std::size_t m_head = 0;
+    std::size_t m_tail = 0;
+};
+
+// Analytics consumer: totals over the whole run
+class EventStats {
+public:
+    void consume(const EventStream& events);
+    void print(std::ostream& out, const EventStream& events) const;
+
+private:
+    std::size_t m_counts[4] = {};
+    std::size_t m_bullets = 0;
+};
@@ -24,12 +24,17 @@ MenuManager::MenuManager() {
     m_exitText.setCharacterSize(30);
     m_exitText.setFillColor(sf::Color::Red);
     m_exitText.setPosition({ 400.f, 400.f });
+
+    m_loadingText.setFont(m_font);
+    m_loadingText.setCharacterSize(30);
+    m_loadingText.setFillColor(sf::Color::White);
+    m_loadingText.setPosition({ 400.f, 350.f });
 }
 
 void MenuManager::handleEvent(const sf::Event& event, GameState& state) {
     if (event.is<sf::Event::KeyPressed>()) {
         auto key = event.getIf<sf::Event::KeyPressed>()->code;
-        if (key == sf::Keyboard::Key::Enter) {
+        if (key == sf::Keyboard::Key::Enter && m_progress >= 1.f) {
             state = GameState::Playing;
             ScoreManager::reset();
         }
@@ -41,6 +46,11 @@ void MenuManager::handleEvent(const sf::Event& event, GameState& state) {
 
 void MenuManager::draw(sf::RenderWindow& window) {
     window.draw(m_title);
-    window.draw(m_playText);
+    window.draw(m_progress >= 1.f ? m_playText : m_loadingText);
     window.draw(m_exitText);
 }
+
+void MenuManager::setProgress(float progress) {
+    m_progress = progress;
+    m_loadingText.setString("Loading... " + std::to_string(static_cast<int>(progress * 100.f)) + "%");
+}
@@ -9,10 +9,14 @@ public:
     void handleEvent(const sf::Event& event, GameState& state);
 
     void draw(sf::RenderWindow& window);
+    // Below 1, ENTER is ignored and the progress replaces the play prompt
+    void setProgress(float progress);
 
 private:
     sf::Font m_font;
     sf::Text m_title = sf::Text(m_font);
     sf::Text m_playText = sf::Text(m_font);
     sf::Text m_exitText = sf::Text(m_font);
+    sf::Text m_loadingText = sf::Text(m_font);
+    float m_progress = 1.f;
 };
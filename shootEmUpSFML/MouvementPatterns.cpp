@@ -1,15 +1,15 @@
 #include "MovementPatterns.hpp"
 #include <cmath>
-#include "Entity.hpp"
 #include "randomGenerator.hpp"
 #include <iostream>
+#include <stdexcept>
 
 namespace MovementPatterns {
 
     constexpr float M_PI = 3.14159265f;
 
     MovementPattern linearAngleDirection(float speed) {
-        return [speed](Entity& e, float dt, PatternState& state) {
+        return [speed](sf::Vector2f& position, float dt, PatternState& state) {
             if (!state.init) {
                 state.init = true;
                 float rad = state.angle * 3.14159265f / 180.f;
@@ -17,12 +17,12 @@ namespace MovementPatterns {
                 state.yVelocity = std::sin(rad) * speed;
             }
 
-            e.move({ state.xVelocity * dt, state.yVelocity * dt });
+            position += sf::Vector2f(state.xVelocity * dt, state.yVelocity * dt);
             };
     }
 
     MovementPattern linearAngleDirectionAccelerate(float speed, float accelerate) {
-        return [speed, accelerate](Entity& e, float dt, PatternState& state) {
+        return [speed, accelerate](sf::Vector2f& position, float dt, PatternState& state) {
 
             if (!state.init) {
                 state.init = true;
@@ -34,7 +34,7 @@ namespace MovementPatterns {
                 state.yVelocity = state.acc2 * speed;
             }
 
-            e.move({ state.xVelocity * dt, state.yVelocity * dt });
+            position += sf::Vector2f(state.xVelocity * dt, state.yVelocity * dt);
             state.xVelocity += state.acc1 * accelerate;
             state.yVelocity += state.acc2 * accelerate;
             };
@@ -42,13 +42,13 @@ namespace MovementPatterns {
 
 
     MovementPattern cShape(float speedX, float speedY, float deltaSpeedX) {
-        return [speedX, speedY, deltaSpeedX](Entity& e, float dt, PatternState& state) {
+        return [speedX, speedY, deltaSpeedX](sf::Vector2f& position, float dt, PatternState& state) {
 
             if (!state.init) {
                 state.init = true;
                 state.xVelocity = speedX;
             }
-            e.move({ state.xVelocity * state.direction * dt, speedY * dt });
+            position += sf::Vector2f(state.xVelocity * state.direction * dt, speedY * dt);
 
             state.xVelocity -= deltaSpeedX * dt;
 
@@ -57,8 +57,8 @@ namespace MovementPatterns {
     }
 
     MovementPattern moveToRandom(float speed, float minX, float maxX, float minY, float maxY) {
-        return [=](Entity& e, float dt, PatternState& state) {
-            auto pos = e.getPosition();
+        return [=](sf::Vector2f& position, float dt, PatternState& state) {
+            auto pos = position;
 
             if (!state.init) {
                 state.init = true;
@@ -78,14 +78,14 @@ namespace MovementPatterns {
                 float dirX = dx / dist;
                 float dirY = dy / dist;
 
-                e.move({ dirX * speed * dt, dirY * speed * dt });
+                position += sf::Vector2f(dirX * speed * dt, dirY * speed * dt);
             }
             };
     }
 
     MovementPattern bounce(float speedX, float speedY, float minX, float maxX, float minY, float maxY) {
-        return [=](Entity& e, float dt, PatternState& state) {
-            auto pos = e.getPosition();
+        return [=](sf::Vector2f& position, float dt, PatternState& state) {
+            auto pos = position;
 
             if (!state.init) {
                 state.init = true;
@@ -107,9 +107,23 @@ namespace MovementPatterns {
                 state.yVelocity = std::abs(state.yVelocity);
             }
 
-            e.move({ state.xVelocity * dt, state.yVelocity * dt });
+            position += sf::Vector2f(state.xVelocity * dt, state.yVelocity * dt);
             };
     }
 
-    
+    MovementPattern fromName(const std::string& name, const std::vector<float>& p) {
+        auto expect = [&](std::size_t count) {
+            if (p.size() != count) {
+                throw std::invalid_argument(name + " attend " + std::to_string(count) + " parametres");
+            }
+        };
+
+        if (name.empty()) return nullptr;
+        if (name == "linearAngleDirection") { expect(1); return linearAngleDirection(p[0]); }
+        if (name == "linearAngleDirectionAccelerate") { expect(2); return linearAngleDirectionAccelerate(p[0], p[1]); }
+        if (name == "cShape") { expect(3); return cShape(p[0], p[1], p[2]); }
+        if (name == "moveToRandom") { expect(5); return moveToRandom(p[0], p[1], p[2], p[3], p[4]); }
+        if (name == "bounce") { expect(6); return bounce(p[0], p[1], p[2], p[3], p[4], p[5]); }
+        throw std::invalid_argument("pattern inconnu '" + name + "'");
+    }
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include <functional>
-
-class Entity;
+#include <string>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
 
 struct PatternState {
     int direction = 1;
@@ -13,7 +14,8 @@ struct PatternState {
     bool init = false;
 };
 
-using MovementPattern = std::function<void(Entity&, float, PatternState&)>;
+// Moves the position it is given, the pattern state keeps what it needs between frames
+using MovementPattern = std::function<void(sf::Vector2f&, float, PatternState&)>;
 
 namespace MovementPatterns {
 
@@ -26,4 +28,7 @@ namespace MovementPatterns {
     MovementPattern moveToRandom(float speed, float minX, float maxX, float minY, float maxY);
 
     MovementPattern bounce(float speedX, float speedY, float minX, float maxX, float minY, float maxY);
+
+    // Builds one of the patterns above from its config name, nullptr for an empty name
+    MovementPattern fromName(const std::string& name, const std::vector<float>& params);
 } 
@@ -0,0 +1,135 @@
+#include "MusicPlayer.hpp"
+#include <algorithm>
+
+// ---------------- MusicStream ----------------
+void MusicStream::setChunkDuration(sf::Time duration) {
+    std::lock_guard lock(m_mutex);
+    m_chunkDuration = duration;
+}
+
+bool MusicStream::openFromFile(const std::filesystem::path& path) {
+    stop();
+
+    std::lock_guard lock(m_mutex);
+    if (!m_file.openFromFile(path)) return false;
+
+    const auto samplesPerSecond = m_file.getSampleRate() * m_file.getChannelCount();
+    const auto chunkSamples = static_cast<std::size_t>(samplesPerSecond * m_chunkDuration.asSeconds());
+    m_samples.assign(std::max<std::size_t>(chunkSamples, m_file.getChannelCount()), 0);
+
+    initialize(m_file.getChannelCount(), m_file.getSampleRate(), m_file.getChannelMap());
+    return true;
+}
+
+sf::Time MusicStream::getDuration() const {
+    std::lock_guard lock(m_mutex);
+    return m_file.getDuration();
+}
+
+std::size_t MusicStream::getBufferBytes() const {
+    std::lock_guard lock(m_mutex);
+    return m_samples.size() * sizeof(std::int16_t);
+}
+
+std::size_t MusicStream::getDecodedBytes() const {
+    std::lock_guard lock(m_mutex);
+    return static_cast<std::size_t>(m_file.getSampleCount()) * sizeof(std::int16_t);
+}
+
+// Called from the SFML streaming thread
+bool MusicStream::onGetData(Chunk& data) {
+    std::lock_guard lock(m_mutex);
+    const auto count = static_cast<std::size_t>(m_file.read(m_samples.data(), m_samples.size()));
+    data.samples = m_samples.data();
+    data.sampleCount = count;
+    return count == m_samples.size();
+}
+
+void MusicStream::onSeek(sf::Time timeOffset) {
+    std::lock_guard lock(m_mutex);
+    m_file.seek(timeOffset);
+}
+
+// ---------------- MusicPlayer ----------------
+void MusicPlayer::setChunkDuration(sf::Time duration) {
+    for (auto& deck : m_decks) deck.setChunkDuration(duration);
+}
+
+void MusicPlayer::setCrossfade(sf::Time duration) {
+    m_crossfade = duration;
+}
+
+void MusicPlayer::setVolume(float volume) {
+    m_volume = volume;
+    if (m_fade < 0.f) m_decks[m_deck].setVolume(volume);
+}
+
+void MusicPlayer::addTrack(const std::filesystem::path& path) {
+    m_tracks.push_back(path);
+}
+
+bool MusicPlayer::open() {
+    if (m_tracks.empty()) return false;
+    m_deck = 0;
+    m_track = 0;
+    m_opened = openTrack(m_decks[m_deck], m_track);
+    return m_opened;
+}
+
+bool MusicPlayer::openTrack(MusicStream& deck, std::size_t track) {
+    if (!deck.openFromFile(m_tracks[track])) return false;
+    deck.setVolume(m_volume);
+    return true;
+}
+
+void MusicPlayer::play() {
+    if (!m_opened && !open()) return;
+    m_playing = true;
+    m_decks[m_deck].play();
+}
+
+void MusicPlayer::stop() {
+    m_playing = false;
+    m_fade = -1.f;
+    for (auto& deck : m_decks) deck.stop();
+    m_opened = false;
+}
+
+void MusicPlayer::update(sf::Time dt) {
+    if (!m_playing || m_tracks.empty()) return;
+
+    MusicStream& current = m_decks[m_deck];
+    MusicStream& next = m_decks[1 - m_deck];
+
+    if (m_fade < 0.f) {
+        const sf::Time remaining = current.getDuration() - current.getPlayingOffset();
+        if (remaining > m_crossfade && current.getStatus() == sf::SoundSource::Status::Playing) return;
+
+        m_track = (m_track + 1) % m_tracks.size();
+        if (!openTrack(next, m_track)) return;
+        next.setVolume(0.f);
+        next.play();
+        m_fade = 0.f;
+    }
+
+    m_fade = m_crossfade == sf::Time::Zero ? 1.f : m_fade + dt / m_crossfade;
+    const float progress = std::min(m_fade, 1.f);
+    current.setVolume(m_volume * (1.f - progress));
+    next.setVolume(m_volume * progress);
+
+    if (progress >= 1.f) {
+        current.stop();
+        m_deck = 1 - m_deck;
+        m_fade = -1.f;
+    }
+}
+
+std::size_t MusicPlayer::getBufferBytes() const {
+    std::size_t bytes = 0;
+    for (auto& deck : m_decks) bytes += deck.getBufferBytes();
+    return bytes;
+}
+
+std::size_t MusicPlayer::getDecodedBytes() const {
+    return m_decks[m_deck].getDecodedBytes();
+}
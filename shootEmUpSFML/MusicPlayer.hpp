@@ -0,0 +1,60 @@
+#pragma once
+#include <SFML/Audio.hpp>
+#include <filesystem>
+#include <array>
+#include <vector>
+#include <mutex>
+
+// Decodes a music file chunk by chunk instead of holding the whole track in memory.
+class MusicStream : public sf::SoundStream {
+public:
+    void setChunkDuration(sf::Time duration);
+    bool openFromFile(const std::filesystem::path& path);
+
+    sf::Time getDuration() const;
+    // PCM held by the stream vs what a fully decoded sf::SoundBuffer would hold
+    std::size_t getBufferBytes() const;
+    std::size_t getDecodedBytes() const;
+
+protected:
+    bool onGetData(Chunk& data) override;
+    void onSeek(sf::Time timeOffset) override;
+
+private:
+    sf::InputSoundFile m_file;
+    std::vector<std::int16_t> m_samples;
+    sf::Time m_chunkDuration = sf::milliseconds(250);
+    mutable std::mutex m_mutex;
+};
+
+// Loops over a playlist, crossfading between two streams at each track change.
+class MusicPlayer {
+public:
+    void setChunkDuration(sf::Time duration);
+    void setCrossfade(sf::Time duration);
+    void setVolume(float volume);
+
+    void addTrack(const std::filesystem::path& path);
+    bool open();
+
+    void play();
+    void stop();
+    void update(sf::Time dt);
+
+    std::size_t getBufferBytes() const;
+    std::size_t getDecodedBytes() const;
+
+private:
+    bool openTrack(MusicStream& deck, std::size_t track);
+
+    std::vector<std::filesystem::path> m_tracks;
+    std::array<MusicStream, 2> m_decks;
+    std::size_t m_deck = 0;
+    std::size_t m_track = 0;
+
+    sf::Time m_crossfade = sf::seconds(3.f);
+    float m_fade = -1.f;
+    float m_volume = 100.f;
+    bool m_opened = false;
+    bool m_playing = false;
+};
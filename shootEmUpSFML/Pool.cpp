@@ -1,7 +1,8 @@
 #include "Pool.hpp"
-#include "RandomGenerator.hpp"
-#include "SoundManager.hpp"
 #include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
 
 // ===================== Pool =====================
 
@@ -10,7 +11,7 @@ Pool::Pool(
     Entity::Type entityType,
     std::shared_ptr<SpriteComposite> sprite,
     MovementPattern pattern,
-    BulletSpawner bulletSpawner,
+    std::shared_ptr<const BulletProgram> bulletProgram,
     sf::Vector2f hitbox,
     sf::Vector2f hurtbox,
     sf::Vector2f boxOffSet,
@@ -19,13 +20,13 @@ Pool::Pool(
     float fireRate,
     std::shared_ptr<Pool> bulletPool,
     std::shared_ptr<Pool> destructionPool,
-    bool desactivateAfterAnimation,
     PatternState patternState,
     int score
 )
-    : sprite(sprite),
+    : entityType(entityType),
+    sprite(sprite),
     pattern(pattern),
-    bulletSpawner(bulletSpawner),
+    bulletProgram(bulletProgram),
     hitbox(hitbox),
     hurtbox(hurtbox),
     boxOffSet(boxOffSet),
@@ -34,872 +35,462 @@ Pool::Pool(
     fireRate(fireRate),
     bulletPool(bulletPool),
     destructionPool(destructionPool),
-    desactivateAfterAnimation(desactivateAfterAnimation),
     patternState(patternState),
-    score(score)
+    score(score),
+    initialCapacity(capacity),
+    maxCapacity(capacity)
 {
-    pool.reserve(capacity);
-    for (std::size_t i = 0; i < capacity; i++) {
-        pool.push_back(std::make_shared<Entity>(entityType));
-    }
+    hot.resize(capacity);
+    composites.resize(capacity);
+    activeBits.assign((capacity + 63) / 64, 0);
+    timerOf.assign(capacity, TimerWheel::none);
 }
 
-std::shared_ptr<Entity> Pool::spawn(const sf::Vector2f& pos, std::shared_ptr<PatternState> ps) {
-    for (auto& obj : pool) {
-        if (!obj->isActive()) {
-            auto comp = *sprite;
-            obj->setComposite(comp);
-            obj->setHurtbox(hurtbox, boxOffSet);
-            obj->setHitbox(hitbox, boxOffSet);
-            obj->setMovementPattern(pattern);
-            obj->setBulletSpawner(bulletSpawner);
-            obj->setHealth(health);
-            obj->setDamage(damage);
-            obj->setFireRate(fireRate);
-            obj->setBulletPool(bulletPool);
-            obj->setDestructionPool(destructionPool);
-            obj->setDesactivateAfterAnimation(desactivateAfterAnimation);
-            obj->setScore(score);
-            obj->setPosition(pos);
-            obj->activate();
-            if (ps != nullptr) {
-                obj->setPatternState(*ps);
-            } else {
-                obj->setPatternState(patternState);
-            }
-            return obj;
-        }
+std::optional<Entity> Pool::spawn(const sf::Vector2f& pos, std::shared_ptr<PatternState> ps) {
+    if (activeLimit > 0 && activeCount >= activeLimit) return std::nullopt;
+
+    std::size_t slot = findFree(0);
+    if (slot == hot.size()) slot = grow();
+    if (slot == hot.size()) {
+        spawnFailures++;
+        return std::nullopt;
     }
-    return nullptr;
+
+    init(slot, pos, ps != nullptr ? *ps : patternState);
+    return Entity(*this, static_cast<std::uint32_t>(slot));
 }
 
-void Pool::update(float dt) {
-    for (auto& obj : pool) {
-        if (obj->isActive()) {
-            obj->update(dt);
+std::size_t Pool::spawnBatch(const sf::Vector2f* positions, const PatternState* states, std::size_t count) {
+    if (activeLimit > 0) count = std::min(count, activeLimit > activeCount ? activeLimit - activeCount : 0);
 
-            if (obj->getPosition().y < -200.f || obj->getPosition().y > 920.f ||
-                obj->getPosition().x < -200.f || obj->getPosition().x > 1480.f) {
-                obj->deactivate();
-            }
+    std::size_t spawned = 0;
+    for (std::size_t slot = findFree(0); spawned < count && slot < hot.size(); slot = findFree(slot + 1)) {
+        init(slot, positions[spawned], states[spawned]);
+        spawned++;
+    }
+
+    for (std::size_t index = hot.size(); spawned < count && grow() < hot.size(); ) {
+        for (; index < hot.size() && spawned < count; index++) {
+            init(index, positions[spawned], states[spawned]);
+            spawned++;
         }
     }
+
+    spawnFailures += count - spawned;
+    return spawned;
 }
 
-void Pool::draw(sf::RenderWindow& window) {
-    for (auto& obj : pool) {
-        if (obj->isActive()) {
-            window.draw(*obj);
-        }
+// Bits past the last slot are never set, so they read as free and are filtered out at the end
+std::size_t Pool::findFree(std::size_t from) const {
+    for (std::size_t word = from / 64; word < activeBits.size(); word++) {
+        std::uint64_t free = ~activeBits[word];
+        if (word == from / 64) free &= ~std::uint64_t(0) << (from % 64);
+        if (free != 0) return std::min(word * 64 + static_cast<std::size_t>(std::countr_zero(free)), hot.size());
     }
+    return hot.size();
 }
 
-const std::vector<std::shared_ptr<Entity>>& Pool::getPool() const {
-    return pool;
+void Pool::schedule(std::size_t slot, float delay) {
+    cancelTimer(slot);
+    timerOf[slot] = timers.schedule(delay, static_cast<std::uint32_t>(slot));
 }
 
-// ===================== PoolManager =====================
+void Pool::cancelTimer(std::size_t slot) {
+    if (timerOf[slot] == TimerWheel::none) return;
+    timers.cancel(timerOf[slot]);
+    timerOf[slot] = TimerWheel::none;
+}
 
-// PLAYER
+std::size_t Pool::grow() {
+    if (growChunk == 0 || hot.size() >= maxCapacity) return hot.size();
 
-std::shared_ptr<SpriteComposite> PoolManager::createPlayerSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto base1 = std::make_shared<SpriteWrapper>("assets/player/ms1.png");
-    auto base2 = std::make_shared<SpriteWrapper>("assets/player/ms2.png");
-    auto base3 = std::make_shared<SpriteWrapper>("assets/player/ms3.png");
-    auto base4 = std::make_shared<SpriteWrapper>("assets/player/ms4.png");
-    auto engineBase = std::make_shared<SpriteWrapper>("assets/player/engineBase.png");
-    auto engineIdle = std::make_shared<SpriteWrapper>("assets/player/engineIdle.png");
-    auto enginePowering = std::make_shared<SpriteWrapper>("assets/player/enginePowering.png");
-    auto canon = std::make_shared<SpriteWrapper>("assets/player/canon.png");
-
-    std::vector<Frame> engineIdleFrames;
-    for (int i = 0; i < 7; i++)
-        engineIdleFrames.push_back(Frame{ sf::IntRect({i * 48, 0}, {48, 48}) });
-    auto engineIdleAnim = std::make_shared<Animation>(engineIdleFrames, 0.1f);
-
-    std::vector<Frame> enginePoweringFrames; for (int i = 0; i < 7; i++)
-        enginePoweringFrames.push_back(Frame{ sf::IntRect({i * 48, 0}, {48, 48}) });
-    auto enginePoweringAnim = std::make_shared<Animation>(enginePoweringFrames, 0.07f);
-    std::vector<Frame> canonFrames;
-
-    for (int i = 0; i < 7; i++)
-        canonFrames.push_back(Frame{ sf::IntRect({i * 48, 0}, {48, 48}) });
-    auto canonAnim = std::make_shared<Animation>(canonFrames, 0.05f);
-
-    comp->addChild(engineIdle, engineIdleAnim, { 0.f, 0.f });
-    comp->addChild(enginePowering, enginePoweringAnim, { 0.f, 0.f });
-    comp->addChild(canon, canonAnim, { 0.f, 0.f });
-    comp->addChild(engineBase, nullptr, { 0.f, 0.f });
-    comp->addChild(base1, nullptr, { 0.f, 0.f });
-    comp->addChild(base2, nullptr, { 0.f, 0.f });
-    comp->addChild(base3, nullptr, { 0.f, 0.f });
-    comp->addChild(base4, nullptr, { 0.f, 0.f });
-    comp->setAnimationActive(1, false);
-    comp->setVisible(1, false);
-    comp->setAnimationActive(2, false);
-    comp->setVisible(5, false);
-    comp->setVisible(6, false);
-    comp->setVisible(7, false);
-    return comp;
+    const std::size_t first = hot.size();
+    const std::size_t count = std::min(growChunk, maxCapacity - first);
+    hot.resize(first + count);
+    composites.resize(first + count);
+    activeBits.resize((hot.size() + 63) / 64, 0);
+    timerOf.resize(hot.size(), TimerWheel::none);
+    return first;
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createPlayerBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/player/bullet.png");
-
-    std::vector<Frame> frames;
-    for (int i = 0; i < 4; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 32, 0}, {32, 32}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+float Pool::getAnimationInterval(const sf::Vector2f& position) const {
+    if (animationInterval <= 0.f) return 0.f;
+    const sf::Vector2f delta = position - s_focus;
+    return delta.x * delta.x + delta.y * delta.y > s_focusRadius * s_focusRadius ? animationInterval : 0.f;
+}
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
+SpriteComposite& Pool::syncComposite(std::size_t slot) {
+    SpriteComposite& comp = composites[slot];
+    comp.setPosition(hot[slot].position);
+    comp.setAnimationInterval(getAnimationInterval(hot[slot].position));
     return comp;
 }
 
-// FIGHTER
-
-PoolManager::BulletSpawner PoolManager::fighterBulletSpawner = [](Entity& e, Pool& p, float dt) {
-    int r = RandomGenerator::getInt(1, 2);
-    if (r == 2) r = -1;
-    p.spawn(e.getPosition() + sf::Vector2f(27.5f, 32.f) , std::make_shared<PatternState>(r,90.f,0.f,0.f,0.f,0.f,false));
-    SoundManager::playSwoosh();
-};
+bool Pool::isOffscreen(const sf::Vector2f& position) {
+    return position.y < -200.f || position.y > 920.f || position.x < -200.f || position.x > 1480.f;
+}
 
-std::shared_ptr<SpriteComposite> PoolManager::createFighterSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto main = std::make_shared<SpriteWrapper>("assets/ennemies/ship/fighter.png");
-    auto engine = std::make_shared<SpriteWrapper>("assets/ennemies/engine/fighter.png");
-    auto weapon = std::make_shared<SpriteWrapper>("assets/ennemies/weapon/fighter.png");
-
-    std::vector<Frame> engineFrames;
-    for (int i = 0; i < 8; i++)
-        engineFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto engineAnim = std::make_shared<Animation>(engineFrames, 0.1f);
-
-    std::vector<Frame> weaponFrames;
-    for (int i = 0; i < 9; i++)
-        weaponFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto weaponAnim = std::make_shared<Animation>(weaponFrames, 0.1f);
-
-    comp->addChild(main, nullptr, { 0.f, 0.f });
-    comp->addChild(engine, engineAnim, { 0.f, 0.f });
-    comp->addChild(weapon, weaponAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+void Pool::reset() {
+    std::fill(activeBits.begin(), activeBits.end(), 0);
+    activeCount = 0;
+    timers.clear();
+    std::fill(timerOf.begin(), timerOf.end(), TimerWheel::none);
+    culledCount = 0;
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createFighterBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/ennemies/projectile/spinning bullet.png");
+// Culled against the pool sprite's bounds at the hot position, so hidden entities never
+// load their composite
+void Pool::draw(RenderQueue& queue, RenderLayer layer) {
+    const sf::FloatRect& viewRect = queue.getViewRect();
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < 8; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 8, 0}, {8, 8}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+    culledCount = 0;
+    if (activeCount == 0 || !sprite) return;
+    const sf::FloatRect& bounds = sprite->getLocalBounds();
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+    forEachActiveSlot([&](std::size_t slot) {
+        if (!viewRect.findIntersection(sf::FloatRect(bounds.position + hot[slot].position, bounds.size))) {
+            culledCount++;
+            return;
+        }
+        syncComposite(slot).submit(queue, layer);
+    });
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createFighterDestructionSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto destruction = std::make_shared<SpriteWrapper>("assets/ennemies/destruction/fighter.png");
-
-    std::vector<Frame> destructionFrames;
-    for (int i = 0; i < 9; i++)
-        destructionFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto destructionAnim = std::make_shared<Animation>(destructionFrames, 0.1f);
+// Single-child strip sprites only (the enemy bullets): one draw call for the whole pool
+void Pool::draw(BulletRenderer& renderer, sf::RenderTarget& target) {
+    culledCount = 0;
+    if (activeCount == 0 || !sprite || sprite->getChildrenCount() == 0) return;
 
-    comp->addChild(destruction, destructionAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
-}
+    const sf::View& view = target.getView();
+    const sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.f, view.getSize());
 
-// SCOUT
+    auto child = sprite->getChild(0);
+    const sf::IntRect rect = child.sprite->get().getTextureRect();
+    const Strip strip = child.anim ? child.anim->getStrip() : Strip{ rect.position, rect.size, { 0, 0 }, 1 };
+    renderer.begin(child.sprite->get().getTexture(), strip, sprite->getFlipX(), sprite->getFlipY());
 
-PoolManager::BulletSpawner PoolManager::scoutBulletSpawner = [](Entity& e, Pool& p, float dt) {
-    p.spawn(e.getPosition() + sf::Vector2f(27.5f, 32.f), std::make_shared<PatternState>(1, RandomGenerator::getFloat(87.f, 93.f), 0.f, 0.f, 0.f, 0.f, false));
-    SoundManager::playSwoosh();
-};
+    const sf::FloatRect& bounds = sprite->getLocalBounds();
 
-std::shared_ptr<SpriteComposite> PoolManager::createScoutSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto main = std::make_shared<SpriteWrapper>("assets/ennemies/ship/scout.png");
-    auto engine = std::make_shared<SpriteWrapper>("assets/ennemies/engine/scout.png");
-    auto weapon = std::make_shared<SpriteWrapper>("assets/ennemies/weapon/scout.png");
-
-    std::vector<Frame> engineFrames;
-    for (int i = 0; i < 8; i++)
-        engineFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto engineAnim = std::make_shared<Animation>(engineFrames, 0.1f);
-
-    std::vector<Frame> weaponFrames;
-    for (int i = 0; i < 7; i++)
-        weaponFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto weaponAnim = std::make_shared<Animation>(weaponFrames, 0.3f);
-
-    comp->addChild(main, nullptr, { 0.f, 0.f });
-    comp->addChild(engine, engineAnim, { 0.f, 0.f });
-    comp->addChild(weapon, weaponAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+    forEachActiveSlot([&](std::size_t slot) {
+        const sf::Vector2f& position = hot[slot].position;
+        if (!viewRect.findIntersection(sf::FloatRect(bounds.position + position, bounds.size))) {
+            culledCount++;
+            return;
+        }
+        SpriteComposite& comp = composites[slot];
+        comp.setAnimationInterval(getAnimationInterval(position));
+        renderer.add(position, comp.getFrameIndex(0));
+    });
+    renderer.end(target);
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createScoutBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/ennemies/projectile/bullet.png");
+const PatternState& Pool::getPatternState() const {
+    return patternState;
+}
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < 8; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 9, 0}, {9, 12}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+Entity::Hot& Pool::getHot(std::size_t slot) {
+    return hot[slot];
+}
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+SpriteComposite& Pool::getComposite(std::size_t slot) {
+    return composites[slot];
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createScoutDestructionSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto destruction = std::make_shared<SpriteWrapper>("assets/ennemies/destruction/scout.png");
+Entity::Type Pool::getType() const {
+    return entityType;
+}
 
-    std::vector<Frame> destructionFrames;
-    for (int i = 0; i < 9; i++)
-        destructionFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto destructionAnim = std::make_shared<Animation>(destructionFrames, 0.1f);
+sf::FloatRect Pool::getHitbox(const sf::Vector2f& position) const {
+    return { position + boxOffSet, hitbox };
+}
 
-    comp->addChild(destruction, destructionAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+sf::FloatRect Pool::getHurtbox(const sf::Vector2f& position) const {
+    return { position + boxOffSet, hurtbox };
 }
 
-// FRIGATE
+int Pool::getDamage() const {
+    return damage;
+}
 
-PoolManager::BulletSpawner PoolManager::frigateBulletSpawner = [](Entity& e, Pool& p, float dt) {
-    p.spawn(e.getPosition() + sf::Vector2f(0.f, 32.f));
-    SoundManager::playSwoosh();
-};
+int Pool::getInitialHealth() const {
+    return health;
+}
 
+int Pool::getScore() const {
+    return score;
+}
 
-std::shared_ptr<SpriteComposite> PoolManager::createFrigateSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto main = std::make_shared<SpriteWrapper>("assets/ennemies/ship/frigate.png");
-    auto engine = std::make_shared<SpriteWrapper>("assets/ennemies/engine/frigate.png");
-    auto weapon = std::make_shared<SpriteWrapper>("assets/ennemies/weapon/frigate.png");
-
-    std::vector<Frame> engineFrames;
-    for (int i = 0; i < 8; i++)
-        engineFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto engineAnim = std::make_shared<Animation>(engineFrames, 0.1f);
-
-    std::vector<Frame> weaponFrames;
-    for (int i = 0; i < 9; i++)
-        weaponFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto weaponAnim = std::make_shared<Animation>(weaponFrames, 0.3f);
-
-    comp->addChild(main, nullptr, { 0.f, 0.f });
-    comp->addChild(engine, engineAnim, { 0.f, 0.f });
-    comp->addChild(weapon, weaponAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+const std::shared_ptr<Pool>& Pool::getDestructionPool() const {
+    return destructionPool;
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createFrigateBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/ennemies/projectile/wave.png");
+std::size_t Pool::getCulledCount() const {
+    return culledCount;
+}
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < 6; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+void Pool::setGrowth(std::size_t chunk, std::size_t maxCapacity) {
+    growChunk = chunk;
+    this->maxCapacity = std::max(maxCapacity, hot.size());
+}
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+std::size_t Pool::getCapacity() const {
+    return hot.size();
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createFrigateDestructionSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto destruction = std::make_shared<SpriteWrapper>("assets/ennemies/destruction/frigate.png");
+std::size_t Pool::getSlotBytes() const {
+    return sizeof(Entity::Hot) + sizeof(SpriteComposite) + sizeof(TimerWheel::Handle);
+}
 
-    std::vector<Frame> destructionFrames;
-    for (int i = 0; i < 9; i++)
-        destructionFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto destructionAnim = std::make_shared<Animation>(destructionFrames, 0.1f);
+std::size_t Pool::getInitialCapacity() const {
+    return initialCapacity;
+}
 
-    comp->addChild(destruction, destructionAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+void Pool::setAnimationInterval(float interval) {
+    animationInterval = interval;
 }
 
-// TORPEDO
+void Pool::setActiveLimit(std::size_t limit) {
+    activeLimit = limit;
+}
 
-PoolManager::BulletSpawner PoolManager::torpedoBulletSpawner = [](Entity& e, Pool& p, float dt) {
-    p.spawn(e.getPosition() + sf::Vector2f(24.f, 32.f), std::make_shared<PatternState>(1, RandomGenerator::getFloat(85.f,95.f), 0.f, 0.f, 0.f, 0.f, false));
-    SoundManager::playRocket();
-};
+void Pool::setFocus(const sf::Vector2f& point, float radius) {
+    s_focus = point;
+    s_focusRadius = radius;
+}
 
-std::shared_ptr<SpriteComposite> PoolManager::createTorpedoSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto main = std::make_shared<SpriteWrapper>("assets/ennemies/ship/torpedo.png");
-    auto engine = std::make_shared<SpriteWrapper>("assets/ennemies/engine/torpedo.png");
-    auto weapon = std::make_shared<SpriteWrapper>("assets/ennemies/weapon/torpedo.png");
-
-    std::vector<Frame> engineFrames;
-    for (int i = 0; i < 8; i++)
-        engineFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto engineAnim = std::make_shared<Animation>(engineFrames, 0.1f);
-
-    std::vector<Frame> weaponFrames;
-    for (int i = 0; i < 16; i++)
-        weaponFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto weaponAnim = std::make_shared<Animation>(weaponFrames, 0.3f);
-
-    comp->addChild(main, nullptr, { 0.f, 0.f });
-    comp->addChild(engine, engineAnim, { 0.f, 0.f });
-    comp->addChild(weapon, weaponAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+std::size_t Pool::getActiveCount() const {
+    return activeCount;
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createTorpedoBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/ennemies/projectile/rocket.png");
+bool Pool::isActive(std::size_t slot) const {
+    return (activeBits[slot / 64] >> (slot % 64)) & 1;
+}
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < 6; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 16, 0}, {16, 32}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+void Pool::setActive(std::size_t slot, bool active) {
+    std::uint64_t& word = activeBits[slot / 64];
+    const std::uint64_t bit = std::uint64_t(1) << (slot % 64);
+    if (((word & bit) != 0) == active) return;
+
+    word ^= bit;
+    if (active) {
+        activeCount++;
+        highWater = std::max(highWater, activeCount);
+    } else {
+        activeCount--;
+        cancelTimer(slot);
+    }
+}
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+std::size_t Pool::getHighWater() const {
+    return highWater;
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createTorpedoDestructionSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto destruction = std::make_shared<SpriteWrapper>("assets/ennemies/destruction/torpedo.png");
+std::size_t Pool::getSpawnFailures() const {
+    return spawnFailures;
+}
 
-    std::vector<Frame> destructionFrames;
-    for (int i = 0; i < 8; i++)
-        destructionFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto destructionAnim = std::make_shared<Animation>(destructionFrames, 0.1f);
+// ===================== PoolOf =====================
+
+// Only the hot records are walked: moving, then offscreen entities collected into a mask
+// and cleared once per word. Emitters and effect ends are not polled: the timer wheel hands
+// back only the slots that are due.
+template <class Traits>
+void PoolOf<Traits>::update(float dt, CommandBuffer& commands, EventStream& events) {
+    if constexpr (Traits::moves) {
+        for (std::size_t word = 0; word < activeBits.size() && activeCount > 0; word++) {
+            std::uint64_t offscreen = 0;
+            for (std::uint64_t bits = activeBits[word]; bits != 0; bits &= bits - 1) {
+                const int bit = std::countr_zero(bits);
+                Entity::Hot& obj = hot[word * 64 + static_cast<std::size_t>(bit)];
+
+                if (pattern) pattern(obj.position, dt, obj.patternState);
+                if (isOffscreen(obj.position)) offscreen |= std::uint64_t(1) << bit;
+            }
 
-    comp->addChild(destruction, destructionAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
-}
+            const std::uint64_t cleared = activeBits[word] & offscreen;
+            activeBits[word] &= ~offscreen;
+            activeCount -= static_cast<std::size_t>(std::popcount(cleared));
+            if constexpr (Traits::fires) {
+                for (std::uint64_t bits = cleared; bits != 0; bits &= bits - 1) {
+                    cancelTimer(word * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+                }
+            }
+        }
+    }
 
-// BOMBER
+    if constexpr (Traits::fires || Traits::despawnsAfterAnimation) {
+        timers.advance(dt, [&](std::uint32_t slot) {
+            timerOf[slot] = TimerWheel::none;
 
-PoolManager::BulletSpawner PoolManager::bomberBulletSpawner = [](Entity& e, Pool& p, float dt) {
-    p.spawn(e.getPosition() + sf::Vector2f(24.f, 32.f), std::make_shared<PatternState>(1, RandomGenerator::getFloat(0.f, 360.f), 0.f, 0.f, 0.f, 0.f, false));
-    SoundManager::playSwoosh();
-};
+            if constexpr (Traits::despawnsAfterAnimation) {
+                // the wheel and AnimationClock advance at different points of the frame, the animation has the last word
+                const double left = composites[slot].getAnimationEnd() - AnimationClock::now();
+                if (left > 0.0) schedule(slot, static_cast<float>(left));
+                else setActive(slot, false);
+            } else {
+                emitters[slot].fire(hot[slot].position, *bulletPool, commands, events);
+                if (emitters[slot].getWait() >= 0.f) schedule(slot, std::max(emitters[slot].getWait(), minEmitterWait));
+            }
+        });
+    }
+}
 
-std::shared_ptr<SpriteComposite> PoolManager::createBomberSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto main = std::make_shared<SpriteWrapper>("assets/ennemies/ship/bomber.png");
-    auto engine = std::make_shared<SpriteWrapper>("assets/ennemies/engine/bomber.png");
+// Only the components the traits ask for are set up: effects get no health or pattern state,
+// and bullets no emitter. Boxes and damage are read from the pool.
+template <class Traits>
+void PoolOf<Traits>::init(std::size_t slot, const sf::Vector2f& pos, const PatternState& state) {
+    SpriteComposite& comp = composites[slot];
+    comp = *sprite;
+    comp.restartAnimations();
+    // effects play their animation once, however they were spawned
+    if constexpr (Traits::despawnsAfterAnimation) comp.stopAnimationAfterLoop(0, true);
+
+    Entity::Hot& obj = hot[slot];
+    obj.position = pos;
+    if constexpr (!Traits::despawnsAfterAnimation) obj.health = health;
+    if constexpr (Traits::moves) obj.patternState = state;
+    setActive(slot, true);
+
+    if constexpr (Traits::despawnsAfterAnimation) {
+        const double end = comp.getAnimationEnd();
+        if (end != std::numeric_limits<double>::infinity()) {
+            schedule(slot, static_cast<float>(end - AnimationClock::now()));
+        }
+    }
 
-    std::vector<Frame> engineFrames;
-    for (int i = 0; i < 8; i++)
-        engineFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto engineAnim = std::make_shared<Animation>(engineFrames, 0.1f);
+    if constexpr (Traits::fires) {
+        if (emitters.size() < hot.size()) emitters.resize(hot.size());
+        emitters[slot].start(bulletProgram, fireRate);
+        if (bulletPool && emitters[slot].getWait() >= 0.f) {
+            schedule(slot, std::max(emitters[slot].getWait(), minEmitterWait));
+        }
+    }
+}
 
-    comp->addChild(main, nullptr, { 0.f, 0.f });
-    comp->addChild(engine, engineAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+template <class Traits>
+std::size_t PoolOf<Traits>::getSlotBytes() const {
+    if constexpr (Traits::fires) return Pool::getSlotBytes() + sizeof(BulletEmitter);
+    else return Pool::getSlotBytes();
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createBomberBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/ennemies/projectile/bomb.png");
+template class PoolOf<BulletTraits>;
+template class PoolOf<ShipTraits>;
+template class PoolOf<EffectTraits>;
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < 16; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 16, 0}, {16, 16}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+// ===================== PoolManager =====================
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+namespace {
+    // Effects end with their animation, ships are the pools with a bullet script, everything else only moves
+    template <class... Args>
+    std::shared_ptr<Pool> makePool(const EntityConfig::PoolDef& def, Args&&... args) {
+        if (def.despawnAfterAnimation) return std::make_shared<EffectPool>(std::forward<Args>(args)...);
+        if (def.emitter != EntityConfig::npos) return std::make_shared<ShipPool>(std::forward<Args>(args)...);
+        return std::make_shared<BulletPool>(std::forward<Args>(args)...);
+    }
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createBomberDestructionSprite() {
+std::shared_ptr<SpriteComposite> PoolManager::createSprite(const EntityConfig& config, std::size_t spriteIndex) {
+    const auto& def = config.sprites[spriteIndex];
     auto comp = std::make_shared<SpriteComposite>();
-    auto destruction = std::make_shared<SpriteWrapper>("assets/ennemies/destruction/bomber.png");
 
-    std::vector<Frame> destructionFrames;
-    for (int i = 0; i < 10; i++)
-        destructionFrames.push_back(Frame{ sf::IntRect({i * 64, 0}, {64, 64}) });
-    auto destructionAnim = std::make_shared<Animation>(destructionFrames, 0.1f);
+    for (std::size_t i = 0; i < def.childCount; i++) {
+        const auto& child = config.children[def.firstChild + i];
+        const auto& sheet = config.sheets[child.sheet];
 
-    comp->addChild(destruction, destructionAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
-}
-
-// BATTLE CRUISER
+        auto spr = std::make_shared<SpriteWrapper>(sheet.path);
+        std::shared_ptr<Animation> anim;
+        if (sheet.strip.count > 0) anim = std::make_shared<Animation>(sheet.strip, sheet.delay);
 
-PoolManager::BulletSpawner PoolManager::battleCruiserBulletSpawner = [](Entity& e, Pool& p, float dt) {
-    p.spawn(e.getPosition() + sf::Vector2f(96.f, 40.f), std::make_shared<PatternState>(1, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    p.spawn(e.getPosition() + sf::Vector2f(96.f, 60.f), std::make_shared<PatternState>(1, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    p.spawn(e.getPosition() + sf::Vector2f(96.f, 80.f), std::make_shared<PatternState>(1, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    p.spawn(e.getPosition() + sf::Vector2f(24.f, 40.f), std::make_shared<PatternState>(-1, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    p.spawn(e.getPosition() + sf::Vector2f(24.f, 60.f), std::make_shared<PatternState>(-1, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    p.spawn(e.getPosition() + sf::Vector2f(24.f, 80.f), std::make_shared<PatternState>(-1, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    p.spawn(e.getPosition() + sf::Vector2f(60.f, 88.f), std::make_shared<PatternState>(0, 90.f, 0.f, 0.f, 0.f, 0.f, false));
-    SoundManager::playSwoosh();
-};
+        comp->addChild(spr, anim, { 0.f, 0.f });
+        if (!child.animationActive) comp->setAnimationActive(i, false);
+        if (!child.visible) comp->setVisible(i, false);
+    }
 
-std::shared_ptr<SpriteComposite> PoolManager::createBattleCruiserSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto main = std::make_shared<SpriteWrapper>("assets/ennemies/ship/battlecruiser.png");
-    auto engine = std::make_shared<SpriteWrapper>("assets/ennemies/engine/battlecruiser.png");
-    auto weapon = std::make_shared<SpriteWrapper>("assets/ennemies/weapon/battlecruiser.png");
-
-    std::vector<Frame> engineFrames;
-    for (int i = 0; i < 8; i++)
-        engineFrames.push_back(Frame{ sf::IntRect({i * 128, 0}, {128, 128}) });
-    auto engineAnim = std::make_shared<Animation>(engineFrames, 0.1f);
-
-    std::vector<Frame> weaponFrames;
-    for (int i = 0; i < 9; i++)
-        weaponFrames.push_back(Frame{ sf::IntRect({i * 128, 0}, {128, 128}) });
-    auto weaponAnim = std::make_shared<Animation>(weaponFrames, 0.3f);
-
-    comp->addChild(main, nullptr, { 0.f, 0.f });
-    comp->addChild(engine, engineAnim, { 0.f, 0.f });
-    comp->flipY = true;
+    comp->setFlip(def.flipX, def.flipY);
+    comp->setBaked(def.bake);
     return comp;
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createBattleCruiserBulletSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto spr = std::make_shared<SpriteWrapper>("assets/ennemies/projectile/spinning bullet.png");
+PoolManager::PoolManager(const EntityConfig& config) {
+    m_pools.reserve(config.pools.size());
+    m_names.reserve(config.pools.size());
+    for (const auto& def : config.pools) {
+        try {
+            m_pools.push_back(makePool(
+                def,
+                def.capacity,
+                def.type,
+                createSprite(config, def.sprite),
+                MovementPatterns::fromName(def.pattern, def.patternParams),
+                def.emitter != EntityConfig::npos ? config.scripts[def.emitter].program : nullptr,
+                def.hitbox,
+                def.hurtbox,
+                def.offset,
+                def.health,
+                def.damage,
+                def.fireRate,
+                def.bullets != EntityConfig::npos ? m_pools[def.bullets] : nullptr,
+                def.destruction != EntityConfig::npos ? m_pools[def.destruction] : nullptr,
+                PatternState(),
+                def.score
+            ));
+        }
+        catch (const std::invalid_argument& e) {
+            throw std::runtime_error("pool " + def.name + ": " + e.what());
+        }
+        m_pools.back()->setGrowth(def.growChunk, def.maxCapacity);
+        m_names.push_back(def.name);
+    }
 
-    std::vector<Frame> frames;
-    for (int i = 0; i < 8; i++)
-        frames.push_back(Frame{ sf::IntRect({i * 8, 0}, {8, 8}) });
-    auto anim = std::make_shared<Animation>(frames, 0.1f);
+    player = m_pools[config.findPool("player")];
+    playerBullet = m_pools[config.findPool("playerBullet")];
+
+    for (const auto& def : config.enemies) {
+        const auto& shipDef = config.pools[def.pool];
+        Enemy enemy;
+        enemy.ship = m_pools[def.pool];
+        if (shipDef.bullets != EntityConfig::npos) enemy.bullet = m_pools[shipDef.bullets];
+        if (shipDef.destruction != EntityConfig::npos) enemy.destruction = m_pools[shipDef.destruction];
+        enemy.cost = def.cost;
+        enemies.push_back(enemy);
+    }
+}
 
-    comp->addChild(spr, anim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+void PoolManager::reset() {
+    for (auto& pool : m_pools) {
+        pool->reset();
+    }
 }
 
-std::shared_ptr<SpriteComposite> PoolManager::createBattleCruiserDestructionSprite() {
-    auto comp = std::make_shared<SpriteComposite>();
-    auto destruction = std::make_shared<SpriteWrapper>("assets/ennemies/destruction/battlecruiser.png");
+std::size_t PoolManager::getCulledCount() const {
+    std::size_t count = 0;
+    for (const auto& pool : m_pools) {
+        count += pool->getCulledCount();
+    }
+    return count;
+}
 
-    std::vector<Frame> destructionFrames;
-    for (int i = 0; i < 13; i++)
-        destructionFrames.push_back(Frame{ sf::IntRect({i * 128, 0}, {128, 128}) });
-    auto destructionAnim = std::make_shared<Animation>(destructionFrames, 0.1f);
+const std::vector<std::shared_ptr<Pool>>& PoolManager::getPools() const {
+    return m_pools;
+}
 
-    comp->addChild(destruction, destructionAnim, { 0.f, 0.f });
-    comp->flipY = true;
-    return comp;
+void PoolManager::spawnEffects(const EventStream& events, CommandBuffer& commands) {
+    events.forEach([&](const GameEvent& event) {
+        if (event.type == GameEvent::Type::Kill && event.effectPool) commands.spawn(*event.effectPool, event.position);
+    });
 }
 
-PoolManager::PoolManager() {
-
-    // PLAYER
-
-    player = Pool(
-        1,
-        Entity::Type::Player,
-        createPlayerSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(32.f, 32.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(8.f, 8.f),
-        20,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    playerBullet = Pool(
-        128,
-        Entity::Type::Player,
-        createPlayerBulletSprite(),
-        MovementPatterns::linearAngleDirection(-400.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(16.f, 16.f),
-        sf::Vector2f(8.f, 8.f),
-        1,
-        1,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    // FIGHTER
-
-    fighterBullet = std::make_shared<Pool>(
-        256,
-        Entity::Type::Enemy,
-        createFighterBulletSprite(),
-        MovementPatterns::cShape(50.f,50.f,10.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(9.f, 12.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        1,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    fighterDestruction = std::make_shared<Pool>(
-        32,
-        Entity::Type::Enemy,
-        createFighterDestructionSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        true,
-        PatternState(),
-        0
-    );
-
-    fighter = Pool(
-        32,
-        Entity::Type::Enemy,
-        createFighterSprite(),
-        MovementPatterns::moveToRandom(100.f,50.f,1200.f,50.f,500.f),
-        fighterBulletSpawner,
-        sf::Vector2f(32.f, 32.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(16.f, 16.f),
-        3,
-        0,
-        2.f,
-        fighterBullet,
-        fighterDestruction,
-        false,
-        PatternState(),
-        10
-    );
-
-    // SCOUT
-
-    scoutBullet = std::make_shared<Pool>(
-        256,
-        Entity::Type::Enemy,
-        createScoutBulletSprite(),
-        MovementPatterns::linearAngleDirection(250.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(9.f, 12.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        1,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState()
-        ,
-        0
-    );
-
-    scoutDestruction = std::make_shared<Pool>(
-        32,
-        Entity::Type::Enemy,
-        createScoutDestructionSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        true,
-        PatternState(),
-        0
-    );
-
-    scout = Pool(
-        32,
-        Entity::Type::Enemy,
-        createScoutSprite(),
-        MovementPatterns::moveToRandom(150.f, 50.f, 1200.f, 50.f, 500.f),
-        scoutBulletSpawner,
-        sf::Vector2f(32.f, 24.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(16.f, 16.f),
-        2,
-        0,
-        3.f,
-        scoutBullet,
-        scoutDestruction,
-        false,
-        PatternState(),
-        10
-    );
-
-    // FRIGATE
-
-    frigateBullet = std::make_shared<Pool>(
-        256,
-        Entity::Type::Enemy,
-        createFrigateBulletSprite(),
-        MovementPatterns::linearAngleDirectionAccelerate(10.f,5.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(40.f, 12.f),
-        sf::Vector2f(12.f, 24.f),
-        1,
-        2,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    frigateDestruction = std::make_shared<Pool>(
-        32,
-        Entity::Type::Enemy,
-        createFrigateDestructionSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        true,
-        PatternState(),
-        0
-    );
-
-    frigate = Pool(
-        32,
-        Entity::Type::Enemy,
-        createFrigateSprite(),
-        MovementPatterns::bounce(50.f, 50.f, 50.f, 1200.f, 120.f, 300.f),
-        frigateBulletSpawner,
-        sf::Vector2f(40.f, 32.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(12.f, 16.f),
-        7,
-        0,
-        4.f,
-        frigateBullet,
-        frigateDestruction,
-        false,
-        PatternState(),
-        25
-    );
-
-    // TORPEDO
-
-    torpedoBullet = std::make_shared<Pool>(
-        256,
-        Entity::Type::Enemy,
-        createTorpedoBulletSprite(),
-        MovementPatterns::linearAngleDirectionAccelerate(0.f,4.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(16.f, 32.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        3,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    torpedoDestruction = std::make_shared<Pool>(
-        32,
-        Entity::Type::Enemy,
-        createTorpedoDestructionSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        true,
-        PatternState(),
-        0
-    );
-
-    torpedo = Pool(
-        32,
-        Entity::Type::Enemy,
-        createTorpedoSprite(),
-        MovementPatterns::moveToRandom(15.f, 50.f, 1200.f, 50.f, 75.f),
-        torpedoBulletSpawner,
-        sf::Vector2f(56.f, 16.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(4.f, 24.f),
-        5,
-        0,
-        5.f,
-        torpedoBullet,
-        torpedoDestruction,
-        false,
-        PatternState(),
-        15
-    );
-
-    // BOMBER 
-
-    bomberBullet = std::make_shared<Pool>(
-        256,
-        Entity::Type::Enemy,
-        createBomberBulletSprite(),
-        MovementPatterns::linearAngleDirection(15.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(16.f, 16.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        5,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    bomberDestruction = std::make_shared<Pool>(
-        32,
-        Entity::Type::Enemy,
-        createBomberDestructionSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        true,
-        PatternState(),
-        0
-    );
-
-    bomber = Pool(
-        32,
-        Entity::Type::Enemy,
-        createBomberSprite(),
-        MovementPatterns::moveToRandom(100.f, 50.f, 1200.f, 50.f, 700.f),
-        bomberBulletSpawner,
-        sf::Vector2f(32.f, 32.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(16.f, 16.f),
-        4,
-        0,
-        10.f,
-        bomberBullet,
-        bomberDestruction,
-        false,
-        PatternState(),
-        15
-    );
-
-    // BATTLE CRUISER 
-
-    battleCruiserBullet = std::make_shared<Pool>(
-        128,
-        Entity::Type::Enemy,
-        createBattleCruiserBulletSprite(),
-        MovementPatterns::cShape(50.f, 50.f, 10.f),
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(8.f, 8.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        1,
-        0.f,
-        nullptr,
-        nullptr,
-        false,
-        PatternState(),
-        0
-    );
-
-    battleCruiserDestruction = std::make_shared<Pool>(
-        32,
-        Entity::Type::Enemy,
-        createBattleCruiserDestructionSprite(),
-        nullptr,
-        nullptr,
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(0.f, 0.f),
-        1,
-        0,
-        0.f,
-        nullptr,
-        nullptr,
-        true,
-        PatternState(),
-        0
-    );
-
-    battleCruiser = Pool(
-        32,
-        Entity::Type::Enemy,
-        createBattleCruiserSprite(),
-        MovementPatterns::moveToRandom(10.f, 50.f, 1200.f, 50.f, 700.f),
-        battleCruiserBulletSpawner,
-        sf::Vector2f(64.f, 88.f),
-        sf::Vector2f(0.f, 0.f),
-        sf::Vector2f(32.f, 16.f),
-        15,
-        0,
-        3.f,
-        battleCruiserBullet,
-        battleCruiserDestruction,
-        false,
-        PatternState(),
-        25
-    );
+void PoolManager::printCapacityReport(std::ostream& out) const {
+    out << "Pools: capacite (initiale -> actuelle), pic, echecs, memoire\n";
+    for (std::size_t i = 0; i < m_pools.size(); i++) {
+        const Pool& pool = *m_pools[i];
+        out << "  " << m_names[i] << ": "
+            << pool.getInitialCapacity() << " -> " << pool.getCapacity()
+            << ", pic " << pool.getHighWater()
+            << ", echecs " << pool.getSpawnFailures()
+            << ", " << pool.getCapacity() * pool.getSlotBytes() << " octets";
+        if (pool.getSpawnFailures() > 0) out << " (trop petit)";
+        else if (pool.getHighWater() * 2 < pool.getInitialCapacity()) out << " (surdimensionne)";
+        out << "\n";
+    }
 }
@@ -1,21 +1,33 @@
 #pragma once
 #include "Entity.hpp"
+#include <bit>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <type_traits>
 #include <vector>
 #include <SFML/Graphics.hpp>
 #include "MovementPatterns.hpp"
-
+#include "BulletRenderer.hpp"
+#include "BulletScript.hpp"
+#include "EntityConfig.hpp"
+#include "CommandBuffer.hpp"
+#include "EventStream.hpp"
+#include "TimerWheel.hpp"
+
+// Entity storage shared by every kind of pool: a hot record and a sprite per slot, in two
+// vectors indexed by slot. Spawn setup and the per-frame update are left to PoolOf<Traits>,
+// which compiles in only the components and stages its entities use.
 class Pool {
 public:
-    using BulletSpawner = std::function<void(Entity&, Pool&, float)>;
-
     Pool(
         std::size_t capacity = 256,
         Entity::Type entityType = Entity::Type::Player,
         std::shared_ptr<SpriteComposite> sprite = nullptr,
         MovementPattern pattern = nullptr,
-        BulletSpawner bulletSpawner = nullptr,
+        std::shared_ptr<const BulletProgram> bulletProgram = nullptr,
         sf::Vector2f hitbox = { 0.f,0.f },
         sf::Vector2f hurtbox = { 0.f,0.f },
         sf::Vector2f boxOffSet = { 0.f,0.f },
@@ -24,22 +36,111 @@ public:
         float fireRate = 0.f,
         std::shared_ptr<Pool> bulletPool = nullptr,
         std::shared_ptr<Pool> destructionPool = nullptr,
-        bool desactivateAfterAnimation = false,
         PatternState patternState = PatternState(),
         int score = 1
     );
-
-    std::shared_ptr<Entity> spawn(const sf::Vector2f& pos, std::shared_ptr<PatternState> ps = nullptr );
-    void update(float dt);
-    void draw(sf::RenderWindow& window);
-
-    const std::vector<std::shared_ptr<Entity>>& getPool() const;
-
-private:
-    std::vector<std::shared_ptr<Entity>> pool;
+    virtual ~Pool() = default;
+
+    // Entity handles point at their pool
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // Empty when every entity is active and the pool cannot grow (counted in getSpawnFailures)
+    std::optional<Entity> spawn(const sf::Vector2f& pos, std::shared_ptr<PatternState> ps = nullptr );
+    // Fills free entities in a single pass, returns how many were spawned. Stops at the active limit.
+    std::size_t spawnBatch(const sf::Vector2f* positions, const PatternState* states, std::size_t count);
+    // Spawns requested by the entities go to `commands`, applied by the caller at its next sync point,
+    // and what they did to `events`
+    virtual void update(float dt, CommandBuffer& commands, EventStream& events) = 0;
+    void reset();
+    void draw(RenderQueue& queue, RenderLayer layer);
+    void draw(BulletRenderer& renderer, sf::RenderTarget& target);
+
+    const PatternState& getPatternState() const;
+
+    // Per-slot storage, what Entity handles read and write
+    Entity::Hot& getHot(std::size_t slot);
+    SpriteComposite& getComposite(std::size_t slot);
+
+    // Settings shared by every entity of the pool
+    Entity::Type getType() const;
+    sf::FloatRect getHitbox(const sf::Vector2f& position) const;
+    sf::FloatRect getHurtbox(const sf::Vector2f& position) const;
+    int getDamage() const;
+    int getInitialHealth() const;
+    int getScore() const;
+    const std::shared_ptr<Pool>& getDestructionPool() const;
+
+    // One bit per slot, 64 to a word. Entity::isActive/activate/deactivate go through these.
+    bool isActive(std::size_t slot) const;
+    void setActive(std::size_t slot, bool active);
+
+    // Calls f(slot) for every active slot, finding them a word at a time with
+    // count-trailing-zeros. f may deactivate the slot it is given.
+    template <class F>
+    void forEachActiveSlot(F&& f) const {
+        for (std::size_t word = 0; word < activeBits.size(); word++) {
+            for (std::uint64_t bits = activeBits[word]; bits != 0; bits &= bits - 1) {
+                f(word * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+            }
+        }
+    }
+    // Same, with an Entity handle
+    template <class F>
+    void forEachActive(F&& f) {
+        forEachActiveSlot([&](std::size_t slot) { f(Entity(*this, static_cast<std::uint32_t>(slot))); });
+    }
+    std::size_t getCulledCount() const;
+
+    // When full, add `chunk` entities at a time up to maxCapacity; 0 keeps the capacity fixed.
+    // Handles are a slot number, so growing never invalidates the ones returned by spawn.
+    void setGrowth(std::size_t chunk, std::size_t maxCapacity);
+
+    std::size_t getCapacity() const;
+    std::size_t getInitialCapacity() const;
+    // Memory owned per slot, for the capacity report
+    virtual std::size_t getSlotBytes() const;
+    // Kept by setActive, so callers can skip empty pools
+    std::size_t getActiveCount() const;
+    // Most entities active at once since construction, kept across reset()
+    std::size_t getHighWater() const;
+    std::size_t getSpawnFailures() const;
+
+    // Quality knobs: animations of entities outside the focus radius advance at most every
+    // interval seconds (0 = every frame), and spawn refuses past limit active entities (0 = no limit)
+    void setAnimationInterval(float interval);
+    void setActiveLimit(std::size_t limit);
+    static void setFocus(const sf::Vector2f& point, float radius = 300.f);
+
+protected:
+    // Sets up the entity in `slot` for a spawn at pos and activates it
+    virtual void init(std::size_t slot, const sf::Vector2f& pos, const PatternState& state) = 0;
+
+    float getAnimationInterval(const sf::Vector2f& position) const;
+    // The sprite of a slot about to be drawn, with the position and animation interval
+    // of its hot record. Not done on every move, so the update loop never touches it.
+    SpriteComposite& syncComposite(std::size_t slot);
+    static bool isOffscreen(const sf::Vector2f& position);
+
+    // At most one timer per slot: the next emitter run of a ship, the end of an effect.
+    // Deactivating a slot cancels its timer.
+    void schedule(std::size_t slot, float delay);
+    // Floor of an emitter's re-arm delay: a script that waits 0 runs once per 60 Hz frame,
+    // as the per-frame countdown did, instead of once per wheel tick
+    static constexpr float minEmitterWait = 1.f / 60.f;
+    void cancelTimer(std::size_t slot);
+
+    std::vector<Entity::Hot> hot;
+    std::vector<SpriteComposite> composites;
+    std::vector<std::uint64_t> activeBits;
+    std::size_t activeCount = 0;
+    TimerWheel timers;
+    std::vector<TimerWheel::Handle> timerOf;
+
+    Entity::Type entityType;
     std::shared_ptr<SpriteComposite> sprite;
     MovementPattern pattern;
-    BulletSpawner bulletSpawner;
+    std::shared_ptr<const BulletProgram> bulletProgram;
     sf::Vector2f hitbox;
     sf::Vector2f hurtbox;
     sf::Vector2f boxOffSet;
@@ -48,82 +149,106 @@ private:
     float fireRate;
     std::shared_ptr<Pool> bulletPool;
     std::shared_ptr<Pool> destructionPool;
-    bool desactivateAfterAnimation;
     PatternState patternState;
     int score;
-};
-
-class PoolManager {
-public:
-    using BulletSpawner = std::function<void(Entity&, Pool&, float)>;
-
-    Pool player;
-    Pool playerBullet;
-
-    Pool fighter;
-    std::shared_ptr<Pool> fighterBullet;
-    std::shared_ptr<Pool> fighterDestruction;
 
-    Pool scout;
-    std::shared_ptr<Pool> scoutBullet;
-    std::shared_ptr<Pool> scoutDestruction;
+private:
+    // First inactive slot at or after `from`, getCapacity() if there is none
+    std::size_t findFree(std::size_t from) const;
+    // Returns the first new slot, getCapacity() when growth is off or maxCapacity is reached
+    std::size_t grow();
+
+    std::size_t culledCount = 0;
+
+    std::size_t initialCapacity;
+    std::size_t growChunk = 0;
+    std::size_t maxCapacity;
+    std::size_t highWater = 0;
+    std::size_t spawnFailures = 0;
+
+    float animationInterval = 0.f;
+    std::size_t activeLimit = 0;
+    inline static sf::Vector2f s_focus{ 0.f, 0.f };
+    inline static float s_focusRadius = 300.f;
+};
 
-    Pool frigate;
-    std::shared_ptr<Pool> frigateBullet;
-    std::shared_ptr<Pool> frigateDestruction;
+// Components and update stages, selected at compile time
+struct BulletTraits {          // player and bullets: movement pattern and offscreen despawn
+    static constexpr bool moves = true;
+    static constexpr bool fires = false;
+    static constexpr bool despawnsAfterAnimation = false;
+};
 
-    Pool torpedo;
-    std::shared_ptr<Pool> torpedoBullet;
-    std::shared_ptr<Pool> torpedoDestruction;
+struct ShipTraits {            // bullets plus a bullet script emitter per entity
+    static constexpr bool moves = true;
+    static constexpr bool fires = true;
+    static constexpr bool despawnsAfterAnimation = false;
+};
 
-    Pool bomber;
-    std::shared_ptr<Pool> bomberBullet;
-    std::shared_ptr<Pool> bomberDestruction;
+struct EffectTraits {          // animation only, gone after its last loop
+    static constexpr bool moves = false;
+    static constexpr bool fires = false;
+    static constexpr bool despawnsAfterAnimation = true;
+};
 
-    Pool battleCruiser;
-    std::shared_ptr<Pool> battleCruiserBullet;
-    std::shared_ptr<Pool> battleCruiserDestruction;
+// Instantiated in Pool.cpp for the traits above
+template <class Traits>
+class PoolOf final : public Pool {
+public:
+    using Pool::Pool;
 
-    PoolManager();
+    void update(float dt, CommandBuffer& commands, EventStream& events) override;
+    std::size_t getSlotBytes() const override;
 
-    // Helpers pour créer les sprites
-    static std::shared_ptr<SpriteComposite> createPlayerSprite();
-    static std::shared_ptr<SpriteComposite> createPlayerBulletSprite();
+private:
+    void init(std::size_t slot, const sf::Vector2f& pos, const PatternState& state) override;
 
-    static std::shared_ptr<SpriteComposite> createFighterSprite();
-    static std::shared_ptr<SpriteComposite> createFighterBulletSprite();
-    static std::shared_ptr<SpriteComposite> createFighterDestructionSprite();
+    struct NoEmitters {};
+    // By slot, grown on spawn; only ships have them
+    std::conditional_t<Traits::fires, std::vector<BulletEmitter>, NoEmitters> emitters;
+};
 
-    static BulletSpawner fighterBulletSpawner;
+using BulletPool = PoolOf<BulletTraits>;
+using ShipPool = PoolOf<ShipTraits>;
+using EffectPool = PoolOf<EffectTraits>;
 
-    static std::shared_ptr<SpriteComposite> createScoutSprite();
-    static std::shared_ptr<SpriteComposite> createScoutBulletSprite();
-    static std::shared_ptr<SpriteComposite> createScoutDestructionSprite();
+class PoolManager {
+public:
+    // A ship pool with the bullet and destruction pools it feeds, bullet may be null
+    struct Enemy {
+        std::shared_ptr<Pool> ship;
+        std::shared_ptr<Pool> bullet;
+        std::shared_ptr<Pool> destruction;
+        int cost = 0;
+    };
 
-    static BulletSpawner scoutBulletSpawner;
+    std::shared_ptr<Pool> player;
+    std::shared_ptr<Pool> playerBullet;
 
-    static std::shared_ptr<SpriteComposite> createFrigateSprite();
-    static std::shared_ptr<SpriteComposite> createFrigateBulletSprite();
-    static std::shared_ptr<SpriteComposite> createFrigateDestructionSprite();
+    // In the order of the config's enemy lines
+    std::vector<Enemy> enemies;
 
-    static BulletSpawner frigateBulletSpawner;
+    // Throws std::runtime_error if the config names a movement pattern that does not exist
+    explicit PoolManager(const EntityConfig& config);
 
-    static std::shared_ptr<SpriteComposite> createTorpedoSprite();
-    static std::shared_ptr<SpriteComposite> createTorpedoBulletSprite();
-    static std::shared_ptr<SpriteComposite> createTorpedoDestructionSprite();
+    // Deactivates every entity in place, keeping allocations and textures
+    void reset();
 
-    static BulletSpawner torpedoBulletSpawner;
+    // Entities skipped by the last draw because they were outside the view
+    std::size_t getCulledCount() const;
 
-    static std::shared_ptr<SpriteComposite> createBomberSprite();
-    static std::shared_ptr<SpriteComposite> createBomberBulletSprite();
-    static std::shared_ptr<SpriteComposite> createBomberDestructionSprite();
+    // Every pool, in config order
+    const std::vector<std::shared_ptr<Pool>>& getPools() const;
 
-    static BulletSpawner bomberBulletSpawner;
+    // Effects consumer: the destruction effect of every Kill in the batch
+    static void spawnEffects(const EventStream& events, CommandBuffer& commands);
 
-    static std::shared_ptr<SpriteComposite> createBattleCruiserSprite();
-    static std::shared_ptr<SpriteComposite> createBattleCruiserBulletSprite();
-    static std::shared_ptr<SpriteComposite> createBattleCruiserDestructionSprite();
+    // Capacity, high-water mark and spawn failures of every pool, to right-size the config
+    void printCapacityReport(std::ostream& out) const;
 
-    static BulletSpawner battleCruiserBulletSpawner;
+    static std::shared_ptr<SpriteComposite> createSprite(const EntityConfig& config, std::size_t spriteIndex);
 
+private:
+    std::vector<std::shared_ptr<Pool>> m_pools;
+    std::vector<std::string> m_names;
 };
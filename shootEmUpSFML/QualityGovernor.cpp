@@ -0,0 +1,51 @@
+#include "QualityGovernor.hpp"
+#include <iostream>
+
+QualityGovernor::QualityGovernor(float budgetMs, float headroomMs)
+    : m_budgetMs(budgetMs),
+    m_headroomMs(headroomMs)
+{
+}
+
+bool QualityGovernor::update(float dt, float frameMs) {
+    m_averageMs += (frameMs - m_averageMs) * 0.1f;
+
+    m_overTime = m_averageMs > m_budgetMs ? m_overTime + dt : 0.f;
+    m_underTime = m_averageMs < m_headroomMs ? m_underTime + dt : 0.f;
+
+    const Level previous = m_level;
+    if (m_overTime >= degradeDelay && m_level != Level::CappedEffects) {
+        m_level = static_cast<Level>(static_cast<int>(m_level) + 1);
+        m_overTime = 0.f;
+    }
+    else if (m_underTime >= restoreDelay && m_level != Level::Full) {
+        m_level = static_cast<Level>(static_cast<int>(m_level) - 1);
+        m_underTime = 0.f;
+    }
+
+    if (m_level == previous) return false;
+    std::cout << "Qualite: niveau " << static_cast<int>(m_level) << " (moyenne " << m_averageMs << " ms)\n";
+    return true;
+}
+
+void QualityGovernor::apply(BackgroundManager& background, PoolManager& pools) const {
+    background.setAnimated(m_level < Level::StaticBackground);
+
+    const float interval = m_level >= Level::ReducedAnimation ? reducedAnimationInterval : 0.f;
+    for (auto& pool : pools.getPools()) {
+        if (pool != pools.player) pool->setAnimationInterval(interval);
+    }
+
+    const std::size_t limit = m_level >= Level::CappedEffects ? effectCap : 0;
+    for (auto& type : pools.enemies) {
+        if (type.destruction) type.destruction->setActiveLimit(limit);
+    }
+}
+
+QualityGovernor::Level QualityGovernor::getLevel() const {
+    return m_level;
+}
+
+float QualityGovernor::getAverageMs() const {
+    return m_averageMs;
+}
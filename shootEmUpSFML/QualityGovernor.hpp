@@ -0,0 +1,38 @@
+#pragma once
+#include "BackgroundManager.hpp"
+#include "Pool.hpp"
+
+// Watches the average update + draw time and lowers quality one level at a time
+// while it stays over budget, then raises it again once there is headroom.
+// Each level keeps the cuts of the previous ones.
+class QualityGovernor {
+public:
+    enum class Level {
+        Full,
+        StaticBackground,   // background frame animation frozen
+        ReducedAnimation,   // entities away from the player animate at 15 Hz
+        CappedEffects       // at most a few destruction effects per enemy type
+    };
+
+    QualityGovernor(float budgetMs = 10.f, float headroomMs = 6.f);
+
+    // Returns true when the level changed, apply() it then
+    bool update(float dt, float frameMs);
+    void apply(BackgroundManager& background, PoolManager& pools) const;
+
+    Level getLevel() const;
+    float getAverageMs() const;
+
+private:
+    static constexpr float degradeDelay = 0.5f;
+    static constexpr float restoreDelay = 3.f;
+    static constexpr float reducedAnimationInterval = 1.f / 15.f;
+    static constexpr std::size_t effectCap = 4;
+
+    float m_budgetMs;
+    float m_headroomMs;
+    float m_averageMs = 0.f;
+    float m_overTime = 0.f;
+    float m_underTime = 0.f;
+    Level m_level = Level::Full;
+};
@@ -0,0 +1,89 @@
+#include "RenderQueue.hpp"
+#include <algorithm>
+
+void RenderQueue::begin(const sf::View& view) {
+    m_viewRect = sf::FloatRect(view.getCenter() - view.getSize() / 2.f, view.getSize());
+    m_items.clear();
+    m_keys.clear();
+    m_cursor = 0;
+    m_drawCalls = 0;
+    m_sorted = false;
+}
+
+void RenderQueue::submit(RenderLayer layer, std::size_t slot, const sf::Texture& texture, const std::array<sf::Vertex, 4>& quad) {
+    // key = layer(8) | slot(8) | texture(16) in the high word, submission index in the low word
+    std::uint64_t key = static_cast<std::uint64_t>(layer) << 56
+        | static_cast<std::uint64_t>(std::min<std::size_t>(slot, 0xFF)) << 48
+        | static_cast<std::uint64_t>(texture.getNativeHandle() & 0xFFFF) << 32
+        | static_cast<std::uint64_t>(m_items.size());
+
+    m_items.push_back({ &texture, quad });
+    m_keys.push_back(key);
+    m_sorted = false;
+}
+
+void RenderQueue::sort() {
+    // LSD radix sort on the 32 high bits; each pass is stable so equal keys keep submission order
+    m_scratch.resize(m_keys.size());
+    for (int shift = 32; shift < 64; shift += 8) {
+        std::size_t counts[256] = {};
+        for (auto key : m_keys) counts[(key >> shift) & 0xFF]++;
+        if (counts[(m_keys.front() >> shift) & 0xFF] == m_keys.size()) continue;
+
+        std::size_t offset = 0;
+        for (auto& count : counts) {
+            std::size_t c = count;
+            count = offset;
+            offset += c;
+        }
+        for (auto key : m_keys) m_scratch[counts[(key >> shift) & 0xFF]++] = key;
+        m_keys.swap(m_scratch);
+    }
+    m_sorted = true;
+}
+
+void RenderQueue::flush(sf::RenderTarget& target, RenderLayer last) {
+    if (m_cursor >= m_keys.size()) return;
+    if (!m_sorted) sort();
+
+    const sf::Texture* texture = nullptr;
+    auto drawBatch = [&]() {
+        if (m_batch.empty()) return;
+        sf::RenderStates states;
+        states.texture = texture;
+        target.draw(m_batch.data(), m_batch.size(), sf::PrimitiveType::Triangles, states);
+        m_batch.clear();
+        m_drawCalls++;
+    };
+
+    for (; m_cursor < m_keys.size(); m_cursor++) {
+        std::uint64_t key = m_keys[m_cursor];
+        if ((key >> 56) > static_cast<std::uint64_t>(last)) break;
+
+        const Item& item = m_items[key & 0xFFFFFFFF];
+        if (item.texture != texture) {
+            drawBatch();
+            texture = item.texture;
+        }
+        // strip order TL, TR, BL, BR -> two triangles
+        m_batch.push_back(item.quad[0]);
+        m_batch.push_back(item.quad[1]);
+        m_batch.push_back(item.quad[2]);
+        m_batch.push_back(item.quad[2]);
+        m_batch.push_back(item.quad[1]);
+        m_batch.push_back(item.quad[3]);
+    }
+    drawBatch();
+}
+
+const sf::FloatRect& RenderQueue::getViewRect() const {
+    return m_viewRect;
+}
+
+std::size_t RenderQueue::getItemCount() const {
+    return m_items.size();
+}
+
+std::size_t RenderQueue::getDrawCallCount() const {
+    return m_drawCalls;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Draw order of the gameplay sprites, lowest first.
+enum class RenderLayer : std::uint8_t {
+    Player,
+    PlayerBullets,
+    Ships,
+    EnemyBullets,
+    Effects
+};
+
+// Collects textured quads for a frame, sorts them by (layer, child slot, texture)
+// and draws each run sharing a texture in a single call.
+class RenderQueue {
+public:
+    void begin(const sf::View& view);
+
+    void submit(RenderLayer layer, std::size_t slot, const sf::Texture& texture, const std::array<sf::Vertex, 4>& quad);
+
+    // Draws every pending item up to and including `last`; later layers stay queued.
+    void flush(sf::RenderTarget& target, RenderLayer last = RenderLayer::Effects);
+
+    const sf::FloatRect& getViewRect() const;
+    std::size_t getItemCount() const;
+    std::size_t getDrawCallCount() const;
+
+private:
+    struct Item {
+        const sf::Texture* texture;
+        std::array<sf::Vertex, 4> quad;
+    };
+
+    void sort();
+
+    std::vector<Item> m_items;
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint64_t> m_scratch;
+    std::vector<sf::Vertex> m_batch;
+
+    sf::FloatRect m_viewRect{};
+    std::size_t m_cursor = 0;
+    std::size_t m_drawCalls = 0;
+    bool m_sorted = false;
+};
@@ -1,4 +1,5 @@
 #include "ScoreManager.hpp"
+#include "EventStream.hpp"
 #include <iostream>
 
 int ScoreManager::s_score = 0;
@@ -23,6 +24,14 @@ void ScoreManager::addScore(int points) {
     s_text.setString("Score: " + std::to_string(s_score));
 }
 
+void ScoreManager::consume(const EventStream& events) {
+    int points = 0;
+    events.forEach([&](const GameEvent& event) {
+        if (event.type == GameEvent::Type::Kill) points += event.value;
+    });
+    if (points != 0) addScore(points);
+}
+
 void ScoreManager::reset() {
     if (!s_initialized) init();
     s_score = 0;
@@ -1,9 +1,13 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 
+class EventStream;
+
 class ScoreManager {
 public:
     static void addScore(int points);
+    // Adds the score of every Kill in the batch, with one text update
+    static void consume(const EventStream& events);
 
     static int getScore();
 
@@ -1,37 +1,206 @@
 #include "SoundManager.hpp"
+#include "AssetLoader.hpp"
+#include "EventStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+std::array<SoundManager::EffectInfo, static_cast<std::size_t>(SoundManager::Effect::Count)> SoundManager::effects;
+std::vector<SoundManager::Voice> SoundManager::voices;
+MusicPlayer SoundManager::music;
+
+SpscQueue<SoundManager::Command, SoundManager::queueCapacity> SoundManager::commands;
+std::atomic<std::size_t> SoundManager::droppedCommands{ 0 };
+std::size_t SoundManager::peakQueueDepth = 0;
+std::jthread SoundManager::audioThread;
+
+namespace {
+    struct EffectDef {
+        const char* path;
+        float volume;
+        int priority;
+        std::size_t maxVoices;
+    };
+
+    // Indexed by SoundManager::Effect
+    constexpr EffectDef effectDefs[] = {
+        { "assets/sound/destruction.wav", 10.f, 3, 4 },
+        { "assets/sound/explosion.wav", 10.f, 3, 2 },
+        { "assets/sound/hit.wav", 10.f, 2, 4 },
+        { "assets/sound/rocket.wav", 1.5f, 1, 3 },
+        { "assets/sound/swoosh.wav", 60.f, 0, 4 }
+    };
+    static_assert(std::size(effectDefs) == static_cast<std::size_t>(SoundManager::Effect::Count));
+}
 
 void SoundManager::init() {
-    if (!bufferBackground.loadFromFile("assets/sound/background.mp3"))
+    sf::Clock musicClock;
+    music.setChunkDuration(musicChunkDuration);
+    music.setCrossfade(sf::seconds(3.f));
+    music.setVolume(2.f);
+    music.addTrack("assets/sound/background.mp3");
+    if (!music.open())
         throw std::runtime_error("Impossible de charger background.mp3");
-    soundBackground.setVolume(2.f);
-    soundBackground.setLooping(true);
+    std::cout << "Musique: ouverte en " << musicClock.getElapsedTime().asMilliseconds() << " ms, "
+        << music.getBufferBytes() / 1024 << " Ko en memoire (" << music.getDecodedBytes() / 1024 << " Ko decodee)\n";
+
+    for (std::size_t i = 0; i < std::size(effectDefs); i++) {
+        const EffectDef& def = effectDefs[i];
+        loadEffect(static_cast<Effect>(i), def.path, def.volume, def.priority, def.maxVoices);
+    }
+
+    voices.clear();
+    voices.reserve(voiceCount);
+    for (std::size_t i = 0; i < voiceCount; i++) {
+        voices.push_back({ sf::Sound(*effects[0].buffer), Effect::Count });
+    }
+
+    audioThread = std::jthread(audioLoop);
+}
+
+void SoundManager::shutdown() {
+    if (!audioThread.joinable()) return;
+    audioThread.request_stop();
+    audioThread.join();
+}
+
+void SoundManager::audioLoop(std::stop_token stop) {
+    sf::Clock clock;
+    while (!stop.stop_requested()) {
+        Command command;
+        while (commands.pop(command)) {
+            switch (command.type) {
+            case Command::Type::PlayEffect:
+                effects[static_cast<std::size_t>(command.effect)].pending = true;
+                break;
+            case Command::Type::PlayBackground:
+                music.play();
+                break;
+            case Command::Type::StopBackground:
+                music.stop();
+                break;
+            }
+        }
+        update();
+        music.update(clock.restart());
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    for (auto& voice : voices) voice.sound.stop();
+    music.stop();
+}
+
+std::vector<std::string> SoundManager::getEffectPaths() {
+    std::vector<std::string> paths;
+    for (const EffectDef& def : effectDefs) paths.push_back(def.path);
+    return paths;
+}
+
+void SoundManager::loadEffect(Effect effect, const std::string& path, float volume, int priority, std::size_t maxVoices) {
+    auto& info = effects[static_cast<std::size_t>(effect)];
+    info.buffer = AssetLoader::getSoundBuffer(path);
+    info.volume = volume;
+    info.priority = priority;
+    info.maxVoices = maxVoices;
+}
+
+// Voice to (re)start for `effect`: the oldest of its own voices once it is at
+// max concurrency, else a free voice, else the oldest voice of the lowest
+// priority effect not above it. nullptr drops the trigger.
+SoundManager::Voice* SoundManager::findVoice(Effect effect) {
+    const auto& info = effects[static_cast<std::size_t>(effect)];
 
-    if (!bufferDestruction.loadFromFile("assets/sound/destruction.wav"))
-        throw std::runtime_error("Impossible de charger destruction.wav");
-    soundDestruction.setVolume(10.f);
+    Voice* oldestSame = nullptr;
+    std::size_t sameCount = 0;
+    Voice* freeVoice = nullptr;
+    Voice* victim = nullptr;
 
-    if (!bufferExplosion.loadFromFile("assets/sound/explosion.wav"))
-        throw std::runtime_error("Impossible de charger explosion.wav");
-    soundExplosion.setVolume(10.f);
+    for (auto& voice : voices) {
+        if (voice.sound.getStatus() != sf::SoundSource::Status::Playing) {
+            if (!freeVoice) freeVoice = &voice;
+            continue;
+        }
+        if (voice.effect == effect) {
+            sameCount++;
+            if (!oldestSame || voice.sound.getPlayingOffset() > oldestSame->sound.getPlayingOffset()) oldestSame = &voice;
+        }
 
-    if (!bufferHit.loadFromFile("assets/sound/hit.wav"))
-        throw std::runtime_error("Impossible de charger hit.wav");
-    soundHit.setVolume(10.f);
+        int priority = effects[static_cast<std::size_t>(voice.effect)].priority;
+        if (priority > info.priority) continue;
+        if (!victim) {
+            victim = &voice;
+            continue;
+        }
+        int victimPriority = effects[static_cast<std::size_t>(victim->effect)].priority;
+        if (priority < victimPriority ||
+            (priority == victimPriority && voice.sound.getPlayingOffset() > victim->sound.getPlayingOffset())) {
+            victim = &voice;
+        }
+    }
 
-    if (!bufferRocket.loadFromFile("assets/sound/rocket.wav"))
-        throw std::runtime_error("Impossible de charger rocket.wav");
-    soundRocket.setVolume(1.5f);
+    if (sameCount >= info.maxVoices) return oldestSame;
+    if (freeVoice) return freeVoice;
+    return victim;
+}
+
+void SoundManager::update() {
+    for (std::size_t i = 0; i < effects.size(); i++) {
+        auto& info = effects[i];
+        if (!info.pending) continue;
+        info.pending = false;
 
-    if (!bufferSwoosh.loadFromFile("assets/sound/swoosh.wav"))
-        throw std::runtime_error("Impossible de charger swoosh.wav");
-    soundSwoosh.setVolume(60.f);
+        Effect effect = static_cast<Effect>(i);
+        Voice* voice = findVoice(effect);
+        if (!voice) continue;
+
+        if (voice->effect != effect) {
+            voice->sound.setBuffer(*info.buffer);
+            voice->sound.setVolume(info.volume);
+            voice->effect = effect;
+        }
+        voice->sound.play();
+    }
 }
 
-void SoundManager::playBackground() { soundBackground.play(); }
-void SoundManager::stopBackground() { soundBackground.stop(); }
+void SoundManager::push(Command command) {
+    if (!commands.push(command)) droppedCommands++;
+    peakQueueDepth = std::max(peakQueueDepth, commands.size());
+}
 
-void SoundManager::playDestruction() { soundDestruction.play(); }
-void SoundManager::playExplosion() { soundExplosion.play(); }
-void SoundManager::playHit() { soundHit.play(); }
-void SoundManager::playRocket() { soundRocket.play(); }
-void SoundManager::playSwoosh() { soundSwoosh.play(); }
+void SoundManager::playBackground() { push({ Command::Type::PlayBackground }); }
+void SoundManager::stopBackground() { push({ Command::Type::StopBackground }); }
+
+void SoundManager::play(Effect effect) { push({ Command::Type::PlayEffect, effect }); }
+void SoundManager::playDestruction() { play(Effect::Destruction); }
+void SoundManager::playExplosion() { play(Effect::Explosion); }
+void SoundManager::playHit() { play(Effect::Hit); }
+void SoundManager::playRocket() { play(Effect::Rocket); }
+void SoundManager::playSwoosh() { play(Effect::Swoosh); }
+
+void SoundManager::consume(const EventStream& events) {
+    std::array<bool, static_cast<std::size_t>(Effect::Count) + 1> triggered{};
+    events.forEach([&](const GameEvent& event) {
+        Effect effect = Effect::Count;
+        switch (event.type) {
+        case GameEvent::Type::Hit: effect = Effect::Hit; break;
+        case GameEvent::Type::Kill: effect = Effect::Destruction; break;
+        case GameEvent::Type::Fire: effect = event.sound; break;
+        case GameEvent::Type::PlayerDamaged: effect = event.health <= 0 ? Effect::Destruction : Effect::Hit; break;
+        }
+        triggered[static_cast<std::size_t>(effect)] = true;
+    });
+
+    // the audio thread starts one voice per effect and tick anyway
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Effect::Count); i++) {
+        if (triggered[i]) play(static_cast<Effect>(i));
+    }
+}
+
+std::size_t SoundManager::getQueueDepth() { return commands.size(); }
+std::size_t SoundManager::getPeakQueueDepth() { return peakQueueDepth; }
+std::size_t SoundManager::getDroppedCommands() { return droppedCommands; }
+
+void SoundManager::printStats(std::ostream& out) {
+    out << "Son: file " << getQueueDepth() << " / " << queueCapacity << " commandes (pic " << getPeakQueueDepth()
+        << "), " << getDroppedCommands() << " perdues\n";
+}
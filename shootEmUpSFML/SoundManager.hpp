@@ -1,37 +1,101 @@
 #pragma once
 #include <SFML/Audio.hpp>
 #include <stdexcept>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <stop_token>
+#include <thread>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "SpscQueue.hpp"
+#include "MusicPlayer.hpp"
 
+class EventStream;
 
 class SoundManager {
 public:
+    enum class Effect {
+        Destruction,
+        Explosion,
+        Hit,
+        Rocket,
+        Swoosh,
+        Count
+    };
+
+    // Loads every sound and starts the audio thread, which owns all sf::Sound objects.
+    // The play functions only enqueue a command for that thread. The thread is also
+    // stopped and joined at exit if shutdown() is never reached, e.g. after a startup error.
     static void init();
+    static void shutdown();
+    // What init() loads, for AssetLoader to decode ahead of it
+    static std::vector<std::string> getEffectPaths();
 
     static void playBackground();
     static void stopBackground();
 
-    static void playDestruction(); 
-    static void playExplosion(); 
-    static void playHit(); 
+    static void play(Effect effect);
+    static void playDestruction();
+    static void playExplosion();
+    static void playHit();
     static void playRocket();
     static void playSwoosh();
 
+    // Plays the frame's gameplay events, each effect at most once per batch
+    static void consume(const EventStream& events);
+
+    static std::size_t getQueueDepth();
+    // Deepest the queue got, seen from the game thread
+    static std::size_t getPeakQueueDepth();
+    static std::size_t getDroppedCommands();
+    static void printStats(std::ostream& out);
+
 private:
-    inline static sf::SoundBuffer bufferBackground;
-    inline static sf::Sound soundBackground{ bufferBackground };
+    struct Command {
+        enum class Type : std::uint8_t {
+            PlayEffect,
+            PlayBackground,
+            StopBackground
+        };
+        Type type = Type::PlayEffect;
+        Effect effect = Effect::Count;
+    };
+
+    struct EffectInfo {
+        std::shared_ptr<const sf::SoundBuffer> buffer;
+        float volume = 100.f;
+        int priority = 0;
+        std::size_t maxVoices = 1;
+        bool pending = false;
+    };
+
+    struct Voice {
+        sf::Sound sound;
+        Effect effect = Effect::Count;
+    };
 
-    inline static sf::SoundBuffer bufferDestruction;
-    inline static sf::Sound soundDestruction{ bufferDestruction };
+    static constexpr std::size_t voiceCount = 12;
+    static constexpr std::size_t queueCapacity = 256;
+    static constexpr sf::Time musicChunkDuration = sf::milliseconds(250);
 
-    inline static sf::SoundBuffer bufferExplosion;
-    inline static sf::Sound soundExplosion{ bufferExplosion };
+    static void loadEffect(Effect effect, const std::string& path, float volume, int priority, std::size_t maxVoices);
+    static Voice* findVoice(Effect effect);
+    static void push(Command command);
+    static void audioLoop(std::stop_token stop);
+    // Starts the effects triggered since the last tick, at most one voice per effect.
+    static void update();
 
-    inline static sf::SoundBuffer bufferHit;
-    inline static sf::Sound soundHit{ bufferHit };
+    static MusicPlayer music;
 
-    inline static sf::SoundBuffer bufferRocket;
-    inline static sf::Sound soundRocket{ bufferRocket };
+    static std::array<EffectInfo, static_cast<std::size_t>(Effect::Count)> effects;
+    static std::vector<Voice> voices;
 
-    inline static sf::SoundBuffer bufferSwoosh;
-    inline static sf::Sound soundSwoosh{ bufferSwoosh };
+    static SpscQueue<Command, queueCapacity> commands;
+    static std::atomic<std::size_t> droppedCommands;
+    static std::size_t peakQueueDepth;
+    // Defined last in SoundManager.cpp so it is destroyed, and joined, before the sounds it plays
+    static std::jthread audioThread;
 };
@@ -1,41 +1,42 @@
 #include "SpriteComposite.hpp"
+#include "AssetLoader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 // ---------------- Animation ----------------
-Animation::Animation(std::vector<Frame> frames, float delaySec)
-    : m_frames(std::move(frames)), m_delay(delaySec) {
-}
-
-bool Animation::update(float dt) {
-    if (m_frames.empty()) return false;
-    m_elapsed += dt;
-    bool finished = false;
-    if (m_elapsed >= m_delay) {
-        m_elapsed = 0.f;
-        m_index++;
-        if (m_index >= m_frames.size()) {
-            m_index = 0;
-            finished = true;
-        }
-    }
-    return finished;
+Animation::Animation(const Strip& strip, float delaySec)
+    : m_strip(strip), m_delay(delaySec) {
+}
+
+std::size_t Animation::getIndex(double elapsed) const {
+    if (m_strip.count < 2 || m_delay <= 0.f || elapsed <= 0.0) return 0;
+    return static_cast<std::size_t>(elapsed / m_delay) % static_cast<std::size_t>(m_strip.count);
 }
 
-void Animation::reset() {
-    m_index = 0;
-    m_elapsed = 0.f;
+sf::IntRect Animation::getRect(std::size_t index) const {
+    return m_strip.getRect(index);
 }
 
-const sf::IntRect& Animation::getRect() const {
-    return m_frames[m_index].rect;
+sf::IntRect Animation::getFirstRect() const {
+    return m_strip.getRect(0);
 }
 
-const sf::IntRect& Animation::getFirstRect() const {
-    return m_frames[0].rect;
+std::size_t Animation::getFrameCount() const {
+    return static_cast<std::size_t>(m_strip.count);
+}
+
+double Animation::getLoopDuration() const {
+    return static_cast<double>(m_delay) * m_strip.count;
+}
+
+const Strip& Animation::getStrip() const {
+    return m_strip;
 }
 
 // ---------------- SpriteWrapper ----------------
 SpriteWrapper::SpriteWrapper(const std::filesystem::path& path)
-    : m_texture(), m_sprite(initSprite(m_texture, path)) {
+    : m_texture(AssetLoader::getTexture(path)), m_sprite(*m_texture) {
 }
 
 sf::Sprite& SpriteWrapper::get() {
@@ -50,89 +51,366 @@ void SpriteWrapper::setRect(const sf::IntRect& rect) {
     m_sprite.setTextureRect(rect);
 }
 
-sf::Sprite SpriteWrapper::initSprite(sf::Texture& tex, const std::filesystem::path& path) {
-    if (!tex.loadFromFile(path)) {
-        throw std::runtime_error("Impossible de charger " + path.string());
-    }
-    return sf::Sprite(tex);
-}
-
 // ---------------- SpriteComposite ----------------
 void SpriteComposite::addChild(std::shared_ptr<SpriteWrapper> sprite,
     std::shared_ptr<Animation> anim,
     sf::Vector2f offset) {
-    m_children.push_back({ sprite, anim, offset, true, anim != nullptr, false, false });
+    m_children.push_back({ sprite, anim, offset, true, anim != nullptr, AnimationClock::now() });
+    m_quads.push_back({});
+
+    sf::Vector2f size = anim ? sf::Vector2f(anim->getFirstRect().size) : sf::Vector2f(sprite->get().getTextureRect().size);
+    sf::FloatRect childBounds(offset, size);
+    if (m_children.size() == 1) {
+        m_localBounds = childBounds;
+    } else {
+        sf::Vector2f min = { std::min(m_localBounds.position.x, childBounds.position.x),
+                             std::min(m_localBounds.position.y, childBounds.position.y) };
+        sf::Vector2f max = { std::max(m_localBounds.position.x + m_localBounds.size.x, childBounds.position.x + childBounds.size.x),
+                             std::max(m_localBounds.position.y + m_localBounds.size.y, childBounds.position.y + childBounds.size.y) };
+        m_localBounds = sf::FloatRect(min, max - min);
+    }
+    m_globalBoundsDirty = true;
 }
 
 void SpriteComposite::setVisible(std::size_t index, bool visible) {
-    if (index < m_children.size()) m_children[index].visible = visible;
+    if (index < m_children.size()) {
+        auto& child = m_children[index];
+        settle(child);
+        child.visible = visible;
+    }
 }
 
+// Activating a running animation keeps its phase and only cancels a pending stop
 void SpriteComposite::setAnimationActive(std::size_t index, bool active) {
     if (index < m_children.size()) {
         auto& child = m_children[index];
         if (child.anim) {
-            child.stopAfterCurrentLoop = false;
+            settle(child);
+            child.stopTime = std::numeric_limits<double>::infinity();
+            child.hideOnStop = false;
+            if (active && !child.animActive) child.startTime = AnimationClock::now();
             child.animActive = active;
-            if (!active) child.anim->reset();
         }
     }
 }
 
-bool SpriteComposite::isAnimationGoing() {
+bool SpriteComposite::isAnimationGoing() const {
     for (auto& child : m_children) {
-        if (child.animActive) return true;
+        if (isActive(child)) return true;
     }
     return false;
 }
 
-void SpriteComposite::update(float dt) {
+double SpriteComposite::getAnimationEnd() const {
+    double end = -std::numeric_limits<double>::infinity();
     for (auto& child : m_children) {
-        if (!child.visible) continue;
-        if (child.anim) {
-            bool finishedLoop = false;
-            if (child.animActive) finishedLoop = child.anim->update(dt);
-            child.sprite->setRect(child.anim->getRect());
-
-            if (child.stopAfterCurrentLoop && finishedLoop) {
-                child.animActive = false;
-                child.stopAfterCurrentLoop = false;
-                if (child.stopAfterCurrentLoopVisibleToggle) {
-                    child.visible = false;
-                    child.stopAfterCurrentLoopVisibleToggle = false;
-                }
-            }
-        }
+        if (child.animActive) end = std::max(end, child.stopTime);
     }
+    return end;
 }
 
+void SpriteComposite::restartAnimations() {
+    const double now = AnimationClock::now();
+    for (auto& child : m_children) {
+        child.startTime = now;
+        child.stopTime = std::numeric_limits<double>::infinity();
+        child.hideOnStop = false;
+    }
+}
+
+// Stops at the end of the loop in progress, back on the first frame
 void SpriteComposite::stopAnimationAfterLoop(std::size_t index, bool visibleToggle) {
     if (index < m_children.size()) {
         auto& child = m_children[index];
-        if (child.anim) {
-            child.stopAfterCurrentLoop = true;
-            child.stopAfterCurrentLoopVisibleToggle = visibleToggle;
+        if (!child.anim) return;
+        settle(child);
+        if (!child.animActive) return;
+
+        const double loop = child.anim->getLoopDuration();
+        const double loops = loop > 0.0 ? std::floor((AnimationClock::now() - child.startTime) / loop) : 0.0;
+        child.stopTime = child.startTime + (loops + 1.0) * loop;
+        child.hideOnStop = visibleToggle;
+    }
+}
+
+void SpriteComposite::setAnimationInterval(float interval) {
+    m_animationInterval = interval;
+}
+
+void SpriteComposite::settle(Child& child) {
+    if (AnimationClock::now() < child.stopTime) return;
+    child.animActive = false;
+    if (child.hideOnStop) child.visible = false;
+    child.stopTime = std::numeric_limits<double>::infinity();
+    child.hideOnStop = false;
+}
+
+bool SpriteComposite::isActive(const Child& child) {
+    return child.animActive && AnimationClock::now() < child.stopTime;
+}
+
+bool SpriteComposite::isVisible(const Child& child) {
+    return child.visible && !(child.hideOnStop && AnimationClock::now() >= child.stopTime);
+}
+
+std::size_t SpriteComposite::getFrame(const Child& child) const {
+    if (!child.anim || !isActive(child)) return 0;
+
+    double now = AnimationClock::now();
+    if (m_animationInterval > 0.f) now = std::floor(now / m_animationInterval) * m_animationInterval;
+    return child.anim->getIndex(now - child.startTime);
+}
+
+// Pools sync every drawn sprite each frame, most of which have not moved
+void SpriteComposite::setPosition(sf::Vector2f position) {
+    if (position == getPosition()) return;
+    sf::Transformable::setPosition(position);
+    invalidateTransform();
+}
+
+void SpriteComposite::move(sf::Vector2f offset) {
+    sf::Transformable::move(offset);
+    invalidateTransform();
+}
+
+void SpriteComposite::setFlip(bool flipX, bool flipY) {
+    if (flipX == m_flipX && flipY == m_flipY) return;
+    m_flipX = flipX;
+    m_flipY = flipY;
+    invalidateTransform();
+}
+
+bool SpriteComposite::getFlipX() const {
+    return m_flipX;
+}
+
+bool SpriteComposite::getFlipY() const {
+    return m_flipY;
+}
+
+std::size_t SpriteComposite::getFrameIndex(std::size_t index) const {
+    return getFrame(m_children[index]);
+}
+
+const sf::FloatRect& SpriteComposite::getLocalBounds() const {
+    return m_localBounds;
+}
+
+const sf::FloatRect& SpriteComposite::getGlobalBounds() const {
+    if (m_globalBoundsDirty) {
+        // flipped children are mirrored around their own rect, so the union stays the same
+        m_globalBounds = getTransform().transformRect(m_localBounds);
+        m_globalBoundsDirty = false;
+    }
+    return m_globalBounds;
+}
+
+void SpriteComposite::invalidateTransform() {
+    for (auto& quad : m_quads) quad.dirty = true;
+    m_bakedQuad.dirty = true;
+    m_globalBoundsDirty = true;
+}
+
+void SpriteComposite::setBaked(bool baked) {
+    m_bake.reset();
+    m_bakedQuad.dirty = true;
+    if (!baked) return;
+
+    // a mask bit per baked child
+    constexpr std::size_t maxBaked = 32;
+    std::size_t first = 0;
+    while (first < m_children.size()) {
+        std::size_t last = first;
+        while (last < m_children.size() && !m_children[last].anim && last - first < maxBaked) last++;
+        if (last - first >= 2) {
+            m_bake = std::make_shared<Bake>();
+            m_bake->first = first;
+            m_bake->last = last;
+            break;
+        }
+        first = last + 1;
+    }
+    if (!m_bake) return;
+
+    for (std::size_t i = m_bake->first; i < m_bake->last; i++) {
+        const sf::FloatRect rect(m_children[i].offset, sf::Vector2f(m_children[i].sprite->get().getTextureRect().size));
+        if (i == m_bake->first) {
+            m_bake->bounds = rect;
+            continue;
+        }
+        const sf::Vector2f min = { std::min(m_bake->bounds.position.x, rect.position.x),
+                                   std::min(m_bake->bounds.position.y, rect.position.y) };
+        const sf::Vector2f max = { std::max(m_bake->bounds.position.x + m_bake->bounds.size.x, rect.position.x + rect.size.x),
+                                   std::max(m_bake->bounds.position.y + m_bake->bounds.size.y, rect.position.y + rect.size.y) };
+        m_bake->bounds = sf::FloatRect(min, max - min);
+    }
+
+    // the only GPU read back, once per texture
+    std::unordered_map<const sf::Texture*, sf::Image> readBack;
+    for (std::size_t i = m_bake->first; i < m_bake->last; i++) {
+        const sf::Sprite& sprite = m_children[i].sprite->get();
+        auto [it, added] = readBack.try_emplace(&sprite.getTexture());
+        if (added) it->second = sprite.getTexture().copyToImage();
+
+        const sf::IntRect rect = sprite.getTextureRect();
+        sf::Image& source = m_bake->sources.emplace_back(sf::Vector2u(rect.size), sf::Color::Transparent);
+        if (!source.copy(it->second, { 0, 0 }, rect)) {
+            std::cerr << "Erreur: impossible de precalculer le sprite\n";
+        }
+    }
+
+    if (const std::uint64_t key = bakeKey(); key != 0) {
+        if (auto texture = compose(static_cast<std::uint32_t>(key))) m_bake->images[key] = texture;
+    }
+}
+
+bool SpriteComposite::isBaked(std::size_t index) const {
+    return m_bake && index >= m_bake->first && index < m_bake->last;
+}
+
+// Visibility mask in the low 32 bits, flips above it; 0 when no baked child is visible
+std::uint64_t SpriteComposite::bakeKey() const {
+    std::uint32_t mask = 0;
+    for (std::size_t i = m_bake->first; i < m_bake->last; i++) {
+        if (isVisible(m_children[i])) mask |= 1u << (i - m_bake->first);
+    }
+    if (mask == 0) return 0;
+    return mask | std::uint64_t(m_flipX) << 32 | std::uint64_t(m_flipY) << 33;
+}
+
+const sf::Texture* SpriteComposite::getBakedTexture() const {
+    const std::uint64_t key = bakeKey();
+    if (key == 0) return nullptr;
+
+    auto& texture = m_bake->images[key];
+    if (!texture) texture = compose(static_cast<std::uint32_t>(key));
+    return texture.get();
+}
+
+// Composed on the CPU with the straight-alpha "over" operator, flips and child colors applied,
+// so the result blends exactly like the children drawn one by one
+std::shared_ptr<const sf::Texture> SpriteComposite::compose(std::uint32_t mask) const {
+    const sf::Vector2u size(m_bake->bounds.size);
+    sf::Image image(size, sf::Color::Transparent);
+    for (std::size_t i = m_bake->first; i < m_bake->last; i++) {
+        if (!(mask & 1u << (i - m_bake->first))) continue;
+
+        const auto& child = m_children[i];
+        const sf::Image& source = m_bake->sources[i - m_bake->first];
+        const sf::Vector2i rectSize(source.getSize());
+        const sf::Color tint = child.sprite->get().getColor();
+        const sf::Vector2i origin(child.offset - m_bake->bounds.position);
+
+        for (int y = 0; y < rectSize.y; y++) {
+            for (int x = 0; x < rectSize.x; x++) {
+                const int sx = m_flipX ? rectSize.x - 1 - x : x;
+                const int sy = m_flipY ? rectSize.y - 1 - y : y;
+                const sf::Color src = source.getPixel(sf::Vector2u(sf::Vector2i(sx, sy))) * tint;
+                if (src.a == 0) continue;
+
+                const sf::Vector2u at(sf::Vector2i(origin.x + x, origin.y + y));
+                const sf::Color dst = image.getPixel(at);
+                const float sa = src.a / 255.f;
+                const float da = dst.a / 255.f * (1.f - sa);
+                const float a = sa + da;
+                auto over = [&](std::uint8_t s, std::uint8_t d) {
+                    return static_cast<std::uint8_t>((s * sa + d * da) / a + 0.5f);
+                };
+                image.setPixel(at, sf::Color(over(src.r, dst.r), over(src.g, dst.g), over(src.b, dst.b),
+                    static_cast<std::uint8_t>(a * 255.f + 0.5f)));
+            }
         }
     }
+
+    auto baked = std::make_shared<sf::Texture>();
+    if (!baked->loadFromImage(image)) {
+        std::cerr << "Erreur: impossible de precalculer le sprite\n";
+        return nullptr;
+    }
+    return baked;
+}
+
+const std::array<sf::Vertex, 4>& SpriteComposite::getBakedQuad() const {
+    if (m_bakedQuad.dirty) {
+        const sf::Transform& transform = getTransform();
+        const sf::Vector2f position = m_bake->bounds.position;
+        const sf::Vector2f size = m_bake->bounds.size;
+        const sf::Vector2f corners[4] = { { 0.f, 0.f }, { size.x, 0.f }, { 0.f, size.y }, size };
+        for (std::size_t i = 0; i < 4; i++) {
+            m_bakedQuad.vertices[i] = sf::Vertex{ transform.transformPoint(position + corners[i]), sf::Color::White, corners[i] };
+        }
+        m_bakedQuad.dirty = false;
+    }
+    return m_bakedQuad.vertices;
+}
+
+void SpriteComposite::updateQuad(const Child& child, Quad& quad) const {
+    const sf::IntRect rect = child.anim ? child.anim->getRect(getFrame(child)) : child.sprite->get().getTextureRect();
+    if (!quad.dirty && rect == quad.rect) return;
+
+    const sf::Transform& transform = getTransform();
+    const sf::Vector2f size(rect.size);
+    const sf::Vector2f corners[4] = {
+        child.offset,
+        child.offset + sf::Vector2f(size.x, 0.f),
+        child.offset + sf::Vector2f(0.f, size.y),
+        child.offset + size
+    };
+
+    // mirroring the texture coordinates is the same as mirroring the sprite around its own rect
+    float left = static_cast<float>(rect.position.x);
+    float top = static_cast<float>(rect.position.y);
+    float right = left + size.x;
+    float bottom = top + size.y;
+    if (m_flipX) std::swap(left, right);
+    if (m_flipY) std::swap(top, bottom);
+    const sf::Vector2f texCoords[4] = { { left, top }, { right, top }, { left, bottom }, { right, bottom } };
+
+    const sf::Color color = child.sprite->get().getColor();
+    for (std::size_t i = 0; i < 4; i++) {
+        quad.vertices[i] = sf::Vertex{ transform.transformPoint(corners[i]), color, texCoords[i] };
+    }
+    quad.rect = rect;
+    quad.dirty = false;
 }
 
 void SpriteComposite::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    states.transform *= getTransform();
-    for (auto& child : m_children) {
-        if (!child.visible) continue;
+    for (std::size_t i = 0; i < m_children.size(); i++) {
+        if (isBaked(i)) {
+            if (i != m_bake->first) continue;
+            if (const sf::Texture* texture = getBakedTexture()) {
+                const auto& quad = getBakedQuad();
+                states.texture = texture;
+                target.draw(quad.data(), quad.size(), sf::PrimitiveType::TriangleStrip, states);
+            }
+            continue;
+        }
+
+        auto& child = m_children[i];
+        if (!isVisible(child)) continue;
+
+        auto& quad = m_quads[i];
+        updateQuad(child, quad);
 
-        sf::Sprite sprite = child.sprite->get();
-        sprite.setPosition(child.offset);
+        states.texture = &child.sprite->get().getTexture();
+        target.draw(quad.vertices.data(), quad.vertices.size(), sf::PrimitiveType::TriangleStrip, states);
+    }
+}
 
-        sf::FloatRect bounds = sprite.getLocalBounds();
-        if (flipX || flipY) {
-            sprite.setOrigin({ flipX ? bounds.size.x : 0.f,
-                              flipY ? bounds.size.y : 0.f });
-            sprite.setScale({ flipX ? -1.f : 1.f,
-                             flipY ? -1.f : 1.f });
+void SpriteComposite::submit(RenderQueue& queue, RenderLayer layer) const {
+    for (std::size_t i = 0; i < m_children.size(); i++) {
+        if (isBaked(i)) {
+            if (i != m_bake->first) continue;
+            if (const sf::Texture* texture = getBakedTexture()) queue.submit(layer, i, *texture, getBakedQuad());
+            continue;
         }
 
-        target.draw(sprite, states);
+        auto& child = m_children[i];
+        if (!isVisible(child)) continue;
+
+        auto& quad = m_quads[i];
+        updateQuad(child, quad);
+        queue.submit(layer, i, child.sprite->get().getTexture(), quad.vertices);
     }
 }
 
@@ -1,29 +1,61 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <filesystem>
+#include <array>
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include "RenderQueue.hpp"
 
-struct Frame {
-    sf::IntRect rect;
+// Frames of a sheet laid out at a fixed step: frame i is the cell at origin + i * stride.
+// Rects are computed, so an animation costs a few ints instead of a vector of rects.
+struct Strip {
+    sf::Vector2i origin{ 0, 0 };
+    sf::Vector2i cellSize{ 0, 0 };
+    sf::Vector2i stride{ 0, 0 };
+    int count = 0;
+
+    // Left to right from (0, 0), the usual layout of the asset sheets
+    static constexpr Strip row(sf::Vector2i cellSize, int count) {
+        return { { 0, 0 }, cellSize, { cellSize.x, 0 }, count };
+    }
+
+    constexpr sf::IntRect getRect(std::size_t index) const {
+        return { origin + stride * static_cast<int>(index), cellSize };
+    }
 };
 
-class Animation {
+// Time every sprite animation is evaluated at. Advanced once per gameplay frame,
+// so nothing animates while the game is not being played.
+class AnimationClock {
 public:
-    Animation(std::vector<Frame> frames, float delaySec);
+    static void advance(float dt) { s_now += dt; }
+    static double now() { return s_now; }
+
+private:
+    static inline double s_now = 0.0;
+};
 
-    bool update(float dt);
-    void reset();
+// Looping strip of frames. Holds no playback state, so one instance is shared
+// by every copy of a sprite: the frame is computed from the time since start.
+class Animation {
+public:
+    Animation(const Strip& strip, float delaySec);
 
-    const sf::IntRect& getRect() const;
-    const sf::IntRect& getFirstRect() const;
+    // floor(elapsed / delay) mod frame count
+    std::size_t getIndex(double elapsed) const;
+    sf::IntRect getRect(std::size_t index) const;
+    sf::IntRect getFirstRect() const;
+    std::size_t getFrameCount() const;
+    double getLoopDuration() const;
+    const Strip& getStrip() const;
 
 private:
-    std::vector<Frame> m_frames;
+    Strip m_strip;
     float m_delay;
-    float m_elapsed = 0.f;
-    std::size_t m_index = 0;
 };
 
 class SpriteWrapper {
@@ -36,25 +68,23 @@ public:
     void setRect(const sf::IntRect& rect);
 
 private:
-    static sf::Sprite initSprite(sf::Texture& tex, const std::filesystem::path& path);
-
-    sf::Texture m_texture;
+    std::shared_ptr<const sf::Texture> m_texture;
     sf::Sprite  m_sprite;
 };
 
 class SpriteComposite : public sf::Drawable, public sf::Transformable {
 public:
-    bool flipX = false;
-    bool flipY = false;
-
+    // Playback is evaluated against AnimationClock when drawn: a paused child shows
+    // its first frame, and a pending stopAnimationAfterLoop takes effect at stopTime.
     struct Child {
         std::shared_ptr<SpriteWrapper> sprite;
         std::shared_ptr<Animation> anim;
         sf::Vector2f offset{ 0.f,0.f };
         bool visible = true;
         bool animActive = true;
-        bool stopAfterCurrentLoop = false;
-        bool stopAfterCurrentLoopVisibleToggle = false;
+        double startTime = 0.0;
+        double stopTime = std::numeric_limits<double>::infinity();
+        bool hideOnStop = false;
     };
 
     void addChild(std::shared_ptr<SpriteWrapper> sprite,
@@ -63,13 +93,84 @@ public:
 
     void setVisible(std::size_t index, bool visible);
     void setAnimationActive(std::size_t index, bool active);
-    bool isAnimationGoing();
-    void update(float dt);
+    bool isAnimationGoing() const;
+    // AnimationClock time at which isAnimationGoing turns false, infinity while one loops on
+    double getAnimationEnd() const;
+    // Starts every animation over from now, called when a pool spawns the composite
+    void restartAnimations();
     void stopAnimationAfterLoop(std::size_t index, bool visibleToggle = false);
+    // > 0 steps the displayed frames at most that often, which also spares quad rebuilds
+    void setAnimationInterval(float interval);
     size_t getChildrenCount();
     Child getChild(int index);
 
+    void setPosition(sf::Vector2f position);
+    void move(sf::Vector2f offset);
+    void setFlip(bool flipX, bool flipY);
+    bool getFlipX() const;
+    bool getFlipY() const;
+    std::size_t getFrameIndex(std::size_t index) const;
+
+    void submit(RenderQueue& queue, RenderLayer layer) const;
+
+    // Flattens the first run of two or more children without animation into one
+    // image per set of visible children and flips, drawn as a single quad. The images
+    // are shared by every copy of this composite. Call after the children are set:
+    // their pixels are read back from the GPU here, and the current image composed.
+    void setBaked(bool baked);
+
+    // Union of every child rect, in composite space / in world space.
+    const sf::FloatRect& getLocalBounds() const;
+    const sf::FloatRect& getGlobalBounds() const;
+
 private:
+    // World-space vertices of one child, rebuilt only when the composite moves,
+    // flips or the child switches to another frame.
+    struct Quad {
+        std::array<sf::Vertex, 4> vertices;
+        sf::IntRect rect;
+        bool dirty = true;
+    };
+
+    // Children [first, last), their union in composite space, a CPU copy of their
+    // texture rects and one image per visibility mask and flips (see bakeKey)
+    struct Bake {
+        std::size_t first = 0;
+        std::size_t last = 0;
+        sf::FloatRect bounds{};
+        std::vector<sf::Image> sources;
+        std::unordered_map<std::uint64_t, std::shared_ptr<const sf::Texture>> images;
+    };
+
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void updateQuad(const Child& child, Quad& quad) const;
+    void invalidateTransform();
+
+    // Applies a stop that is due, before the child's flags are changed
+    static void settle(Child& child);
+    static bool isActive(const Child& child);
+    static bool isVisible(const Child& child);
+    std::size_t getFrame(const Child& child) const;
+
+    bool isBaked(std::size_t index) const;
+    std::uint64_t bakeKey() const;
+    // Image for the children visible right now, composed from the CPU copy on first use,
+    // null when none are visible
+    const sf::Texture* getBakedTexture() const;
+    std::shared_ptr<const sf::Texture> compose(std::uint32_t mask) const;
+    const std::array<sf::Vertex, 4>& getBakedQuad() const;
+
     std::vector<Child> m_children;
+    mutable std::vector<Quad> m_quads;
+
+    std::shared_ptr<Bake> m_bake;
+    mutable Quad m_bakedQuad;
+
+    bool m_flipX = false;
+    bool m_flipY = false;
+    float m_animationInterval = 0.f;
+
+    sf::FloatRect m_localBounds{};
+    mutable sf::FloatRect m_globalBounds{};
+    mutable bool m_globalBoundsDirty = true;
 };
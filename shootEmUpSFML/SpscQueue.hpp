@@ -0,0 +1,38 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size lock-free queue for exactly one producer thread and one consumer thread.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false when the queue is full.
+    bool push(const T& value) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) return false;
+        m_items[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool pop(T& value) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        value = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t size() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> m_head{ 0 };
+    alignas(64) std::atomic<std::size_t> m_tail{ 0 };
+    std::array<T, Capacity> m_items{};
+};
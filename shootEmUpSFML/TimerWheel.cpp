@@ -0,0 +1,87 @@
+#include "TimerWheel.hpp"
+#include <algorithm>
+#include <cmath>
+
+TimerWheel::TimerWheel(float tickSeconds) : m_tick(tickSeconds) {
+    m_heads.fill(none);
+}
+
+TimerWheel::Handle TimerWheel::schedule(float delay, std::uint32_t id) {
+    const float ticks = std::ceil((m_pending + std::max(delay, 0.f)) / m_tick);
+    const std::uint64_t due = static_cast<std::uint64_t>(std::min(ticks, static_cast<float>(horizon - 1)));
+
+    Handle handle = m_free;
+    if (handle != none) {
+        m_free = m_nodes[handle].next;
+    } else {
+        handle = static_cast<Handle>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    m_nodes[handle].expire = m_now + std::max<std::uint64_t>(due, 1);
+    m_nodes[handle].id = id;
+    link(handle);
+    m_count++;
+    return handle;
+}
+
+void TimerWheel::cancel(Handle handle) {
+    unlink(handle);
+    m_nodes[handle].next = m_free;
+    m_free = handle;
+    m_count--;
+}
+
+void TimerWheel::clear() {
+    m_nodes.clear();
+    m_free = none;
+    m_heads.fill(none);
+    m_occupied.fill(0);
+    m_count = 0;
+}
+
+std::size_t TimerWheel::size() const {
+    return m_count;
+}
+
+// The level is picked by distance, so a slot always comes round again before its timers are due
+void TimerWheel::link(Handle handle) {
+    Node& node = m_nodes[handle];
+    const std::uint64_t distance = node.expire - m_now;
+
+    std::size_t level = 0;
+    while (level + 1 < levelCount && distance >= std::uint64_t(1) << (slotBits * (level + 1))) level++;
+    const std::size_t index = static_cast<std::size_t>(node.expire >> (slotBits * level) & slotMask);
+    const std::size_t slot = level * slotCount + index;
+
+    node.slot = static_cast<std::uint16_t>(slot);
+    node.prev = none;
+    node.next = m_heads[slot];
+    if (node.next != none) m_nodes[node.next].prev = handle;
+    m_heads[slot] = handle;
+    m_occupied[level] |= std::uint64_t(1) << index;
+}
+
+void TimerWheel::unlink(Handle handle) {
+    const Node& node = m_nodes[handle];
+    if (node.prev != none) m_nodes[node.prev].next = node.next;
+    else m_heads[node.slot] = node.next;
+    if (node.next != none) m_nodes[node.next].prev = node.prev;
+
+    if (m_heads[node.slot] == none) {
+        m_occupied[node.slot / slotCount] &= ~(std::uint64_t(1) << (node.slot % slotCount));
+    }
+}
+
+// Unlinks the first timer of a slot, none when it is empty
+TimerWheel::Handle TimerWheel::pop(std::size_t slot) {
+    const Handle handle = m_heads[slot];
+    if (handle != none) unlink(handle);
+    return handle;
+}
+
+// Spreads the current slot of `level` over the levels below; handles stay valid
+void TimerWheel::cascade(std::size_t level) {
+    const std::size_t slot = level * slotCount + static_cast<std::size_t>(m_now >> (slotBits * level) & slotMask);
+    for (Handle handle = pop(slot); handle != none; handle = pop(slot)) link(handle);
+}
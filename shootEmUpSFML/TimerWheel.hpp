@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel: 4 levels of 64 slots, each slot a 64th of the next
+// level's, so schedule and cancel are O(1) and advance only visits the ticks that
+// have a timer due or a slot to cascade. Timers further than 64^4 ticks away are
+// clamped to that horizon (4.6 hours at the default millisecond tick).
+class TimerWheel {
+public:
+    using Handle = std::uint32_t;
+    static constexpr Handle none = ~Handle(0);
+
+    explicit TimerWheel(float tickSeconds = 0.001f);
+
+    // `id` is given back on expiry. Delays are rounded up to whole ticks, at least one,
+    // so a timer scheduled from the expiry callback fires at a later tick.
+    Handle schedule(float delay, std::uint32_t id);
+    // The handle must still be pending: owners forget it when its timer fires
+    void cancel(Handle handle);
+
+    // Moves time forward by dt and calls f(id) for every timer that came due, in due order.
+    // During f the wheel's time is that timer's due tick, so a timer rescheduled from f keeps
+    // its period exactly and may fire again within the same advance. f may schedule and cancel.
+    template <class F>
+    void advance(float dt, F&& f);
+
+    void clear();
+    std::size_t size() const;
+
+private:
+    static constexpr int slotBits = 6;
+    static constexpr std::size_t slotCount = std::size_t(1) << slotBits;
+    static constexpr std::size_t levelCount = 4;
+    static constexpr std::uint64_t slotMask = slotCount - 1;
+    static constexpr std::uint64_t horizon = std::uint64_t(1) << (slotBits * levelCount);
+
+    struct Node {
+        std::uint64_t expire = 0;
+        std::uint32_t id = 0;
+        Handle prev = none;
+        Handle next = none;
+        std::uint16_t slot = 0;  // level * slotCount + index
+    };
+
+    void link(Handle handle);
+    void unlink(Handle handle);
+    Handle pop(std::size_t slot);
+    void cascade(std::size_t level);
+
+    float m_tick;
+    std::uint64_t m_now = 0;
+    float m_pending = 0.f;      // time below one tick, carried to the next advance
+    std::size_t m_count = 0;
+
+    std::vector<Node> m_nodes;
+    Handle m_free = none;
+    std::array<Handle, levelCount * slotCount> m_heads;
+    std::array<std::uint64_t, levelCount> m_occupied{};
+};
+
+template <class F>
+void TimerWheel::advance(float dt, F&& f) {
+    const float total = m_pending + dt;
+    const auto ticks = static_cast<std::uint64_t>(total / m_tick);
+    const std::uint64_t target = m_now + ticks;
+    m_pending = 0.f;
+
+    while (m_now < target) {
+        if (m_count == 0) {
+            m_now = target;
+            break;
+        }
+
+        // next tick worth a visit: the next cascade, or an earlier level-0 slot with timers
+        std::uint64_t next = (m_now | slotMask) + 1;
+        const std::uint64_t first = m_now + 1;
+        if ((first & slotMask) != 0) {
+            const std::uint64_t ahead = m_occupied[0] >> (first & slotMask);
+            if (ahead != 0) next = first + static_cast<std::uint64_t>(std::countr_zero(ahead));
+        }
+        if (next > target) {
+            m_now = target;
+            break;
+        }
+        m_now = next;
+
+        for (std::size_t level = 1; level < levelCount; level++) {
+            if ((m_now >> (slotBits * (level - 1)) & slotMask) != 0) break;
+            cascade(level);
+        }
+
+        for (Handle handle = pop(m_now & slotMask); handle != none; handle = pop(m_now & slotMask)) {
+            const std::uint32_t id = m_nodes[handle].id;
+            m_nodes[handle].next = m_free;
+            m_free = handle;
+            m_count--;
+            f(id);
+        }
+    }
+    m_pending = total - static_cast<float>(ticks) * m_tick;
+}
@@ -4,54 +4,104 @@
 #include "ColisionManager.hpp"
 #include "SoundManager.hpp"
 #include "BackgroundManager.hpp"
-#include "EnemySpawner.hpp"
+#include "Director.hpp"
+#include "QualityGovernor.hpp"
 #include "ScoreManager.hpp"
 #include "GameState.hpp"
 #include "MenuManager.hpp"
 #include "GameOverScreen.hpp"
+#include "RenderQueue.hpp"
+#include "BulletRenderer.hpp"
+#include "Benchmark.hpp"
+#include "AssetLoader.hpp"
+#include "EntityConfig.hpp"
+#include "EventStream.hpp"
 #include <iostream>
 
-void drawHitboxes(sf::RenderWindow& window, const std::vector<std::shared_ptr<Entity>>& entities) {
-    for (auto& e : entities) {
-        if (!e->isActive()) continue;
+void drawHitboxes(sf::RenderWindow& window, Pool& pool) {
+    pool.forEachActive([&](Entity e) {
 
-        sf::RectangleShape hit({ e->getHitbox().size.x, e->getHitbox().size.y });
-        hit.setPosition(e->getHitbox().position);
+        sf::RectangleShape hit({ e.getHitbox().size.x, e.getHitbox().size.y });
+        hit.setPosition(e.getHitbox().position);
         hit.setFillColor(sf::Color::Transparent);
         hit.setOutlineColor(sf::Color::Red);
         hit.setOutlineThickness(1.f);
         window.draw(hit);
 
-        sf::RectangleShape hurt({ e->getHurtbox().size.x, e->getHurtbox().size.y });
-        hurt.setPosition(e->getHurtbox().position);
+        sf::RectangleShape hurt({ e.getHurtbox().size.x, e.getHurtbox().size.y });
+        hurt.setPosition(e.getHurtbox().position);
         hurt.setFillColor(sf::Color::Transparent);
         hurt.setOutlineColor(sf::Color::Blue);
         hurt.setOutlineThickness(1.f);
         window.draw(hurt);
-    }
+    });
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        Benchmark::run();
+        return 0;
+    }
+
     bool displayBox = false;
     sf::RenderWindow window(sf::VideoMode({ 1280, 720 }), "Space shooter");
+    window.setFramerateLimit(60);
+
+    MenuManager menu;
+    GameState state = GameState::Menu;
+    GameOverScreen gameOver;
+
+    const std::string backgrounds[] = { "assets/background/bg1.png", "assets/background/bg2.png" };
+    EntityConfig config("assets/config/entities.cfg");
+
+    // only what the game is about to use, decoded while the menu is already interactive
+    std::vector<std::filesystem::path> preload(std::begin(backgrounds), std::end(backgrounds));
+    for (const auto& sheet : config.sheets) preload.push_back(sheet.path);
+    for (const auto& path : SoundManager::getEffectPaths()) preload.push_back(path);
+    AssetLoader::start(preload);
+
+    while (window.isOpen() && !AssetLoader::isDone()) {
+        AssetLoader::poll();
+        menu.setProgress(AssetLoader::getProgress());
+
+        while (auto event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) {
+                window.close();
+            }
+            if (state == GameState::Menu) {
+                menu.handleEvent(*event, state);
+            }
+        }
+
+        window.clear();
+        if (state == GameState::Menu) menu.draw(window);
+        else gameOver.draw(window, ScoreManager::getScore());
+        window.display();
+    }
+    AssetLoader::shutdown();
+    menu.setProgress(1.f);
+    if (!window.isOpen()) return 0;
 
     SoundManager::init();
     SoundManager::playBackground();
 
     BackgroundManager bgManager;
-    bgManager.addBackground("assets/background/bg1.png", 9, 2.f, 5.f, 100);
-    bgManager.addBackground("assets/background/bg2.png", 9, 0.01f, 25.f, 150);
+    bgManager.addLayer(backgrounds[0], 9, 2.f, 5.f, 100);
+    bgManager.addLayer(backgrounds[1], 9, 0.01f, 25.f, 150);
+    bgManager.setCached(true);
 
     ScoreManager::reset();
 
-    window.setFramerateLimit(60);
-
-    PoolManager pools;
-    EnemySpawner spawner(pools);
+    PoolManager pools(config);
+    Director director(pools, config);
+    QualityGovernor quality;
 
-    std::shared_ptr<Entity> player;
+    std::optional<Entity> player;
 
-    auto colisionManager = ColisionManager(pools);
+    ColisionManager colisionManager(pools);
+    CommandBuffer commands;
+    EventStream events;
+    EventStats stats;
 
     bool shooting = false;
     float timeSinceLastShot = 0.f;
@@ -59,11 +109,14 @@ int main() {
     float minX = 10.f, maxX = 1250.f;
     float minY = 10.f, maxY = 690.f;
 
-    sf::Clock clock;
+    RenderQueue renderQueue;
+    BulletRenderer bulletRenderer;
 
-    GameState state = GameState::Menu;
-    MenuManager menu;
-    GameOverScreen gameOver;
+    sf::Clock clock;
+    sf::Clock workClock;
+    float frameWorkMs = 0.f;
+    std::size_t culledTotal = 0;
+    std::size_t playedFrames = 0;
 
     while (window.isOpen()) {
         float dt = clock.restart().asSeconds();
@@ -76,34 +129,20 @@ int main() {
             if (state == GameState::Menu) {
                 menu.handleEvent(e, state);
                 if (state == GameState::Playing) {
-                    pools = PoolManager();
-                    colisionManager = ColisionManager(pools);
-                    spawner = EnemySpawner(pools);
-                    spawner.addEnemyType(10, [&](sf::Vector2f pos) { pools.fighter.spawn(pos); });
-                    spawner.addEnemyType(10, [&](sf::Vector2f pos) { pools.scout.spawn(pos); });
-                    spawner.addEnemyType(15, [&](sf::Vector2f pos) { pools.bomber.spawn(pos); });
-                    spawner.addEnemyType(15, [&](sf::Vector2f pos) { pools.torpedo.spawn(pos); });
-                    spawner.addEnemyType(20, [&](sf::Vector2f pos) { pools.frigate.spawn(pos); });
-                    spawner.addEnemyType(30, [&](sf::Vector2f pos) { pools.battleCruiser.spawn(pos); });
-
-                    player = pools.player.spawn({ 400.f, 500.f });
+                    pools.reset();
+                    director.reset();
+
+                    player = pools.player->spawn({ 400.f, 500.f });
                     shooting = false;
                 }
             }
             else if (state == GameState::GameOver) {
                 gameOver.handleEvent(e, state);
                 if (state == GameState::Playing) {
-                    pools = PoolManager();
-                    colisionManager = ColisionManager(pools);
-                    spawner = EnemySpawner(pools);
-                    spawner.addEnemyType(10, [&](sf::Vector2f pos) { pools.fighter.spawn(pos); });
-                    spawner.addEnemyType(10, [&](sf::Vector2f pos) { pools.scout.spawn(pos); });
-                    spawner.addEnemyType(15, [&](sf::Vector2f pos) { pools.bomber.spawn(pos); });
-                    spawner.addEnemyType(15, [&](sf::Vector2f pos) { pools.torpedo.spawn(pos); });
-                    spawner.addEnemyType(20, [&](sf::Vector2f pos) { pools.frigate.spawn(pos); });
-                    spawner.addEnemyType(30, [&](sf::Vector2f pos) { pools.battleCruiser.spawn(pos); });
-
-                    player = pools.player.spawn({ 400.f, 500.f });
+                    pools.reset();
+                    director.reset();
+
+                    player = pools.player->spawn({ 400.f, 500.f });
                     shooting = false;
                 }
             }
@@ -131,7 +170,9 @@ int main() {
             menu.draw(window);
         }
         else if (state == GameState::Playing) {
-            spawner.update(dt);
+            workClock.restart();
+            AnimationClock::advance(dt);
+            director.update(dt, frameWorkMs);
             timeSinceLastShot += dt;
 
             sf::Vector2f velocity(0.f, 0.f);
@@ -174,82 +215,77 @@ int main() {
 
             if (shooting && timeSinceLastShot >= fireRate && player) {
                 timeSinceLastShot = 0.f;
-                pools.playerBullet.spawn(player->getPosition() + sf::Vector2f(8.f, -20.f));
-                SoundManager::playSwoosh();
+                const sf::Vector2f position = player->getPosition() + sf::Vector2f(8.f, -20.f);
+                pools.playerBullet->spawn(position);
+
+                events.push({ .type = GameEvent::Type::Fire, .sound = SoundManager::Effect::Swoosh, .position = position, .value = 1 });
             }
 
             bgManager.update(dt);
 
-            pools.player.update(dt);
-            pools.fighter.update(dt);
-            pools.scout.update(dt);
-            pools.frigate.update(dt);
-            pools.torpedo.update(dt);
-            pools.bomber.update(dt);
-            pools.battleCruiser.update(dt);
-
-            pools.playerBullet.update(dt);
-            pools.fighterBullet->update(dt);
-            pools.scoutBullet->update(dt);
-            pools.frigateBullet->update(dt);
-            pools.torpedoBullet->update(dt);
-            pools.bomberBullet->update(dt);
-            pools.battleCruiserBullet->update(dt);
-
-            colisionManager.update();
-
-            pools.fighterDestruction->update(dt);
-            pools.scoutDestruction->update(dt);
-            pools.frigateDestruction->update(dt);
-            pools.torpedoDestruction->update(dt);
-            pools.bomberDestruction->update(dt);
-            pools.battleCruiserDestruction->update(dt);
+            BulletEmitter::setTarget(player->getPosition());
+            Pool::setFocus(player->getPosition());
+            pools.player->update(dt, commands, events);
+            for (auto& type : pools.enemies) type.ship->update(dt, commands, events);
+            // sync point: the bullets fired this frame move with the others
+            commands.apply();
+
+            pools.playerBullet->update(dt, commands, events);
+            for (auto& type : pools.enemies) {
+                if (type.bullet) type.bullet->update(dt, commands, events);
+            }
+
+            colisionManager.update(commands, events);
+
+            // every consumer reads the frame's events in one batch
+            SoundManager::consume(events);
+            ScoreManager::consume(events);
+            stats.consume(events);
+            PoolManager::spawnEffects(events, commands);
+            events.clear();
+
+            // sync point: kills leave the pools and their effects start playing
+            commands.apply();
+
+            for (auto& type : pools.enemies) {
+                if (type.destruction) type.destruction->update(dt, commands, events);
+            }
 
             window.draw(bgManager);
             ScoreManager::draw(window);
 
-            pools.player.draw(window);
-            pools.playerBullet.draw(window);
+            renderQueue.begin(window.getView());
 
-            pools.fighter.draw(window);
-            pools.fighterBullet->draw(window);
-            pools.fighterDestruction->draw(window);
+            pools.player->draw(renderQueue, RenderLayer::Player);
+            pools.playerBullet->draw(renderQueue, RenderLayer::PlayerBullets);
 
-            pools.scout.draw(window);
-            pools.scoutBullet->draw(window);
-            pools.scoutDestruction->draw(window);
-
-            pools.frigate.draw(window);
-            pools.frigateBullet->draw(window);
-            pools.frigateDestruction->draw(window);
+            for (auto& type : pools.enemies) {
+                type.ship->draw(renderQueue, RenderLayer::Ships);
+                if (type.destruction) type.destruction->draw(renderQueue, RenderLayer::Effects);
+            }
 
-            pools.torpedo.draw(window);
-            pools.torpedoBullet->draw(window);
-            pools.torpedoDestruction->draw(window);
+            renderQueue.flush(window, RenderLayer::Ships);
 
-            pools.bomber.draw(window);
-            pools.bomberBullet->draw(window);
-            pools.bomberDestruction->draw(window);
+            for (auto& type : pools.enemies) {
+                if (type.bullet) type.bullet->draw(bulletRenderer, window);
+            }
 
-            pools.battleCruiser.draw(window);
-            pools.battleCruiserBullet->draw(window);
-            pools.battleCruiserDestruction->draw(window);
+            renderQueue.flush(window);
+            culledTotal += pools.getCulledCount();
+            playedFrames++;
 
             if (displayBox) {
-                drawHitboxes(window, pools.player.getPool());
-                drawHitboxes(window, pools.playerBullet.getPool());
-                drawHitboxes(window, pools.fighter.getPool());
-                drawHitboxes(window, pools.fighterBullet->getPool());
-                drawHitboxes(window, pools.scout.getPool());
-                drawHitboxes(window, pools.scoutBullet->getPool());
-                drawHitboxes(window, pools.frigate.getPool());
-                drawHitboxes(window, pools.frigateBullet->getPool());
-                drawHitboxes(window, pools.torpedo.getPool());
-                drawHitboxes(window, pools.torpedoBullet->getPool());
-                drawHitboxes(window, pools.bomber.getPool());
-                drawHitboxes(window, pools.bomberBullet->getPool());
-                drawHitboxes(window, pools.battleCruiser.getPool());
-                drawHitboxes(window, pools.battleCruiserBullet->getPool());
+                drawHitboxes(window, *pools.player);
+                drawHitboxes(window, *pools.playerBullet);
+                for (auto& type : pools.enemies) {
+                    drawHitboxes(window, *type.ship);
+                    if (type.bullet) drawHitboxes(window, *type.bullet);
+                }
+            }
+
+            frameWorkMs = workClock.getElapsedTime().asSeconds() * 1000.f;
+            if (quality.update(dt, frameWorkMs)) {
+                quality.apply(bgManager, pools);
             }
 
             if (!player || !player->isActive()) {
@@ -262,4 +298,13 @@ int main() {
 
         window.display();
     }
+
+    pools.printCapacityReport(std::cout);
+    stats.print(std::cout, events);
+    if (playedFrames > 0) {
+        std::cout << "Culling: " << static_cast<float>(culledTotal) / static_cast<float>(playedFrames)
+            << " entites hors vue par image en moyenne, sur " << playedFrames << " images\n";
+    }
+    SoundManager::printStats(std::cout);
+    SoundManager::shutdown();
 }